@@ -0,0 +1,144 @@
+#include "arena.h"
+#include "raylib.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+thread_local FrameArena frameArena = {};
+
+// -----------------------------------------------------------------------------
+// Arena
+// -----------------------------------------------------------------------------
+void ArenaInit(FrameArena& arena, size_t capacity) {
+    ArenaShutdown(arena);
+    arena.base     = static_cast<uint8_t*>(::operator new(capacity));
+    arena.capacity = capacity;
+}
+
+void ArenaShutdown(FrameArena& arena) {
+    ArenaReset(arena);
+    ::operator delete(arena.base);
+    arena = {};
+}
+
+void ArenaReset(FrameArena& arena) {
+    for (const ArenaOverflowBlock& block : arena.overflow) {
+        if (block.align > alignof(std::max_align_t))
+            ::operator delete(block.p, std::align_val_t(block.align));
+        else
+            ::operator delete(block.p);
+    }
+    arena.overflow.clear();
+    arena.overflowBytes = 0;
+    arena.offset = 0;
+}
+
+void* ArenaAlloc(FrameArena& arena, size_t bytes, size_t align) {
+    const uintptr_t start   = reinterpret_cast<uintptr_t>(arena.base) + arena.offset;
+    const uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+    const size_t    end     = (size_t)(aligned - reinterpret_cast<uintptr_t>(arena.base)) + bytes;
+
+    if (arena.base && end <= arena.capacity) {
+        arena.offset = end;
+        if (end > arena.peak) arena.peak = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Out of frame memory: stay correct, but make it visible
+    if (arena.overflowBytes == 0)
+        TraceLog(LOG_WARNING, "ARENA: Frame arena exhausted (%zu bytes), falling back to the heap", arena.capacity);
+    arena.overflowBytes += bytes;
+    // Aligned new only when it's needed, and the matching delete at reset
+    void* p = (align > alignof(std::max_align_t)) ? ::operator new(bytes, std::align_val_t(align))
+                                                  : ::operator new(bytes);
+    arena.overflow.push_back({ p, align });
+    return p;
+}
+
+const char* FrameFormat(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list measure;
+    va_copy(measure, args);
+    const int length = vsnprintf(nullptr, 0, fmt, measure);
+    va_end(measure);
+
+    char* text = static_cast<char*>(ArenaAlloc(frameArena, (size_t)std::max(length, 0) + 1, 1));
+    vsnprintf(text, (size_t)std::max(length, 0) + 1, fmt, args);
+    va_end(args);
+    return text;
+}
+
+// -----------------------------------------------------------------------------
+// Allocation guard
+// -----------------------------------------------------------------------------
+#if defined(LIX_ALLOC_TRACKING)
+
+static thread_local uint64_t threadAllocations = 0;
+
+struct AllocGuard {
+    uint64_t frameStart;
+    int      frames;
+    int      exemptUntil;    // frames before this index are not checked
+};
+
+static thread_local AllocGuard allocGuard = { 0, 0, allocGuardWarmupFrames };
+
+uint64_t ThreadHeapAllocations() {
+    return threadAllocations;
+}
+
+void AllocGuardBeginFrame() {
+    allocGuard.frameStart = threadAllocations;
+}
+
+void AllocGuardMarkUnsteady() {
+    allocGuard.exemptUntil = std::max(allocGuard.exemptUntil, allocGuard.frames + 2);
+}
+
+uint64_t AllocGuardEndFrame() {
+    const int frame = allocGuard.frames++;
+    if (frame < allocGuard.exemptUntil) return 0;
+    return threadAllocations - allocGuard.frameStart;
+}
+
+// Global replacements; the aligned forms cover over-aligned types such as the
+// enemy accumulators
+static void* CountedAlloc(size_t size, size_t align) {
+    ++threadAllocations;
+    if (size == 0) size = 1;
+#if defined(_WIN32)
+    void* p = (align > alignof(std::max_align_t)) ? _aligned_malloc(size, align) : malloc(size);
+#else
+    void* p = (align > alignof(std::max_align_t)) ? aligned_alloc(align, (size + align - 1) & ~(align - 1))
+                                                  : malloc(size);
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+static void CountedFree(void* p, size_t align) {
+#if defined(_WIN32)
+    if (align > alignof(std::max_align_t)) { _aligned_free(p); return; }
+#else
+    (void)align;
+#endif
+    free(p);
+}
+
+void* operator new(size_t size)                          { return CountedAlloc(size, 0); }
+void* operator new[](size_t size)                        { return CountedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t a)      { return CountedAlloc(size, (size_t)a); }
+void* operator new[](size_t size, std::align_val_t a)    { return CountedAlloc(size, (size_t)a); }
+void  operator delete(void* p) noexcept                       { CountedFree(p, 0); }
+void  operator delete[](void* p) noexcept                     { CountedFree(p, 0); }
+void  operator delete(void* p, size_t) noexcept               { CountedFree(p, 0); }
+void  operator delete[](void* p, size_t) noexcept             { CountedFree(p, 0); }
+void  operator delete(void* p, std::align_val_t a) noexcept   { CountedFree(p, (size_t)a); }
+void  operator delete[](void* p, std::align_val_t a) noexcept { CountedFree(p, (size_t)a); }
+void  operator delete(void* p, size_t, std::align_val_t a) noexcept   { CountedFree(p, (size_t)a); }
+void  operator delete[](void* p, size_t, std::align_val_t a) noexcept { CountedFree(p, (size_t)a); }
+
+#endif
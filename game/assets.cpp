@@ -0,0 +1,286 @@
+#include "assets.h"
+#include "arena.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct AssetEntry {
+    char       path[256];
+    AssetType  type;
+    AssetState state;
+    uint32_t   generation;
+    int        refs;
+    bool       inFlight;       // with the loader; the slot can't be reused until it comes back
+    Image      image;          // decoded, waiting for upload (loader-written)
+    Wave       wave;
+    size_t     decodedBytes;
+    Texture2D  texture;
+    Sound      sound;
+    Music      music;
+};
+
+// Loader thread state, guarded by mutex. Entries' path and type don't change
+// while they are in flight, so the loaders read those unlocked.
+struct AssetLoader {
+    std::thread             threads[assetLoaderThreads];
+    std::mutex              mutex;
+    std::condition_variable wake;       // requests, quit, or room under the decoded limit
+    std::vector<uint32_t>   requests;   // slots to decode, oldest first
+    std::vector<uint32_t>   decoded;    // slots waiting for upload, oldest first
+    size_t                  decodedBytes;
+    bool                    quit;
+};
+
+static AssetEntry  assets[assetSlotCount];
+static AssetLoader loader;
+static uint64_t    assetUploads;
+
+// -----------------------------------------------------------------------------
+// Loader threads
+// -----------------------------------------------------------------------------
+static void LoaderLoop() {
+    std::unique_lock<std::mutex> lock(loader.mutex);
+    while (true) {
+        loader.wake.wait(lock, [] {
+            return loader.quit || (!loader.requests.empty() && loader.decodedBytes < assetDecodedLimit);
+        });
+        if (loader.quit) return;
+
+        const uint32_t slot = loader.requests.front();
+        loader.requests.erase(loader.requests.begin());
+        AssetEntry& entry = assets[slot];
+        lock.unlock();
+
+        Image  image = {};
+        Wave   wave  = {};
+        size_t bytes = 0;
+        if (entry.type == ASSET_TEXTURE) {
+            image = LoadImage(entry.path);
+            if (image.data) bytes = (size_t)GetPixelDataSize(image.width, image.height, image.format);
+        } else {
+            wave = LoadWave(entry.path);
+            if (wave.data) bytes = (size_t)wave.frameCount * wave.channels * (wave.sampleSize / 8);
+        }
+
+        lock.lock();
+        entry.image        = image;
+        entry.wave         = wave;
+        entry.decodedBytes = bytes;
+        loader.decodedBytes += bytes;
+        loader.decoded.push_back(slot);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Lifecycle
+// -----------------------------------------------------------------------------
+void InitAssets() {
+    loader.quit = false;
+    for (std::thread& t : loader.threads)
+        t = std::thread(LoaderLoop);
+}
+
+static void UnloadDecoded(AssetEntry& entry) {
+    if (entry.image.data) UnloadImage(entry.image);
+    if (entry.wave.data) UnloadWave(entry.wave);
+    entry.image = {};
+    entry.wave  = {};
+}
+
+static void UnloadReady(AssetEntry& entry) {
+    if (entry.state != ASSET_READY) return;
+    switch (entry.type) {
+        case ASSET_TEXTURE: UnloadTexture(entry.texture); break;
+        case ASSET_SOUND:   UnloadSound(entry.sound); break;
+        case ASSET_MUSIC:
+            StopMusicStream(entry.music);
+            UnloadMusicStream(entry.music);
+            break;
+    }
+}
+
+void ShutdownAssets() {
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        loader.quit = true;
+    }
+    loader.wake.notify_all();
+    for (std::thread& t : loader.threads)
+        if (t.joinable()) t.join();
+
+    for (uint32_t slot : loader.decoded)
+        UnloadDecoded(assets[slot]);
+    for (AssetEntry& entry : assets)
+        UnloadReady(entry);
+
+    loader.requests.clear();
+    loader.decoded.clear();
+    loader.decodedBytes = 0;
+    for (AssetEntry& entry : assets) entry = {};
+}
+
+// -----------------------------------------------------------------------------
+// Handles
+// -----------------------------------------------------------------------------
+static AssetEntry* Resolve(AssetHandle h) {
+    if (h.generation == 0 || h.slot >= (uint32_t)assetSlotCount) return nullptr;
+    AssetEntry& entry = assets[h.slot];
+    return (entry.state != ASSET_FREE && entry.generation == h.generation) ? &entry : nullptr;
+}
+
+static AssetHandle Acquire(const char* path, AssetType type) {
+    int freeSlot = -1;
+    for (int i = 0; i < assetSlotCount; ++i) {
+        AssetEntry& entry = assets[i];
+        if (entry.state != ASSET_FREE && entry.type == type && strcmp(entry.path, path) == 0) {
+            entry.refs++;
+            return { (uint32_t)i, entry.generation };
+        }
+        if (freeSlot < 0 && entry.state == ASSET_FREE && !entry.inFlight)
+            freeSlot = i;
+    }
+    if (freeSlot < 0 || strlen(path) >= sizeof(AssetEntry::path)) {
+        TraceLog(LOG_WARNING, "ASSETS: No room for %s", path);
+        return nullAsset;
+    }
+
+    AssetEntry& entry = assets[freeSlot];
+    snprintf(entry.path, sizeof(entry.path), "%s", path);
+    entry.type  = type;
+    entry.state = ASSET_QUEUED;
+    entry.refs  = 1;
+    if (++entry.generation == 0) entry.generation = 1;
+
+    // Music only opens its file, which UpdateAssets() does on this thread
+    if (type != ASSET_MUSIC) {
+        entry.inFlight = true;
+        {
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            loader.requests.push_back((uint32_t)freeSlot);
+        }
+        loader.wake.notify_one();
+    }
+    return { (uint32_t)freeSlot, entry.generation };
+}
+
+AssetHandle AcquireTexture(const char* path) { return Acquire(path, ASSET_TEXTURE); }
+AssetHandle AcquireSound(const char* path)   { return Acquire(path, ASSET_SOUND); }
+AssetHandle AcquireMusic(const char* path)   { return Acquire(path, ASSET_MUSIC); }
+
+void ReleaseAsset(AssetHandle& handle) {
+    AssetEntry* entry = Resolve(handle);
+    handle = nullAsset;
+    if (!entry || --entry->refs > 0) return;
+
+    UnloadReady(*entry);
+    entry->state = ASSET_FREE;
+    if (entry->inFlight) {
+        // Still queued: withdraw it. Otherwise the decode is under way and
+        // UpdateAssets() discards it when it comes back.
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        auto queued = std::find(loader.requests.begin(), loader.requests.end(), (uint32_t)(entry - assets));
+        if (queued != loader.requests.end()) {
+            loader.requests.erase(queued);
+            entry->inFlight = false;
+        }
+    }
+}
+
+AssetState GetAssetState(AssetHandle handle) {
+    const AssetEntry* entry = Resolve(handle);
+    return entry ? entry->state : ASSET_FREE;
+}
+
+const Texture2D* GetTexture(AssetHandle handle) {
+    const AssetEntry* entry = Resolve(handle);
+    return (entry && entry->state == ASSET_READY && entry->type == ASSET_TEXTURE) ? &entry->texture : nullptr;
+}
+
+const Sound* GetSound(AssetHandle handle) {
+    const AssetEntry* entry = Resolve(handle);
+    return (entry && entry->state == ASSET_READY && entry->type == ASSET_SOUND) ? &entry->sound : nullptr;
+}
+
+Music* GetMusic(AssetHandle handle) {
+    AssetEntry* entry = Resolve(handle);
+    return (entry && entry->state == ASSET_READY && entry->type == ASSET_MUSIC) ? &entry->music : nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Per frame
+// -----------------------------------------------------------------------------
+static void FinishLoad(AssetEntry& entry) {
+    AllocGuardMarkUnsteady();   // the GPU and audio sides allocate
+    bool ok = false;
+    if (entry.type == ASSET_TEXTURE && entry.image.data) {
+        entry.texture = LoadTextureFromImage(entry.image);
+        ok = IsTextureValid(entry.texture);
+    } else if (entry.type == ASSET_SOUND && entry.wave.data) {
+        entry.sound = LoadSoundFromWave(entry.wave);
+        ok = IsSoundValid(entry.sound);
+    }
+    UnloadDecoded(entry);
+    entry.state = ok ? ASSET_READY : ASSET_FAILED;
+    if (!ok) TraceLog(LOG_WARNING, "ASSETS: Failed to load %s", entry.path);
+    assetUploads++;
+}
+
+void UpdateAssets(double budgetMs) {
+    const double start = GetTime();
+    auto overBudget = [&] { return (GetTime() - start) * 1000.0 >= budgetMs; };
+
+    // At least one upload per frame, so a tiny budget still makes progress
+    bool first = true;
+    while (first || !overBudget()) {
+        uint32_t slot;
+        {
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            if (loader.decoded.empty()) break;
+            slot = loader.decoded.front();
+            loader.decoded.erase(loader.decoded.begin());
+            loader.decodedBytes -= assets[slot].decodedBytes;
+        }
+        loader.wake.notify_one();   // may have made room under the decoded limit
+
+        AssetEntry& entry = assets[slot];
+        entry.inFlight     = false;
+        entry.decodedBytes = 0;
+        if (entry.state == ASSET_FREE) {
+            UnloadDecoded(entry);   // released while decoding
+            continue;
+        }
+        FinishLoad(entry);
+        first = false;
+    }
+
+    for (AssetEntry& entry : assets) {
+        if (entry.type != ASSET_MUSIC) continue;
+        if (entry.state == ASSET_QUEUED && !overBudget()) {
+            AllocGuardMarkUnsteady();
+            entry.music = LoadMusicStream(entry.path);
+            entry.state = IsMusicValid(entry.music) ? ASSET_READY : ASSET_FAILED;
+            if (entry.state == ASSET_FAILED) TraceLog(LOG_WARNING, "ASSETS: Failed to open %s", entry.path);
+        } else if (entry.state == ASSET_READY && IsMusicStreamPlaying(entry.music)) {
+            UpdateMusicStream(entry.music);
+        }
+    }
+}
+
+AssetStats GetAssetStats() {
+    AssetStats stats = {};
+    for (const AssetEntry& entry : assets) {
+        if (entry.state == ASSET_READY)  stats.ready++;
+        if (entry.state == ASSET_QUEUED) stats.queued++;
+        if (entry.state == ASSET_FAILED) stats.failed++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        stats.decodedBytes = loader.decodedBytes;
+    }
+    stats.uploads = assetUploads;
+    return stats;
+}
@@ -0,0 +1,83 @@
+#include "entitypool.h"
+
+void InitHandleTable(HandleTable& table, uint32_t capacity) {
+    table.capacity = capacity;
+    table.generation.assign(capacity, 1);
+    table.slotToDense.assign(capacity, 0);
+    table.denseToSlot.assign(capacity, 0);
+    table.freeSlots.resize(capacity);
+    // Nothing to retire: the generations were just reset, and the old live
+    // range may run past the new capacity
+    table.count = 0;
+    ClearHandleTable(table);
+}
+
+void ClearHandleTable(HandleTable& table) {
+    // Live slots are retired so handles from before the clear go stale
+    for (uint32_t i = 0; i < table.count; ++i)
+        table.generation[table.denseToSlot[i]]++;
+    for (uint32_t& g : table.generation)
+        if (g == 0) g = 1;
+
+    // Lowest slot on top, so a fresh pool hands out slots 0, 1, 2... Sized
+    // before it's filled: a clear after spawns starts from a shorter stack
+    table.freeSlots.resize(table.capacity);
+    for (uint32_t i = 0; i < table.capacity; ++i)
+        table.freeSlots[i] = table.capacity - 1 - i;
+    table.count = 0;
+}
+
+bool RestoreHandleTable(HandleTable& table, const EntityHandle* live, uint32_t count) {
+    ClearHandleTable(table);
+    if (count > table.capacity) return false;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const EntityHandle h = live[i];
+        if (h.slot >= table.capacity || h.generation == 0) return false;
+        table.generation[h.slot] = h.generation;
+        table.slotToDense[h.slot] = i;
+        table.denseToSlot[i]      = h.slot;
+    }
+    // A repeated slot leaves an earlier dense index pointing at a slot that maps elsewhere
+    for (uint32_t i = 0; i < count; ++i) {
+        if (table.slotToDense[table.denseToSlot[i]] != i) {
+            ClearHandleTable(table);
+            return false;
+        }
+    }
+
+    table.freeSlots.clear();
+    for (uint32_t slot = table.capacity; slot-- > 0;) {
+        const uint32_t dense = table.slotToDense[slot];
+        if (dense >= count || table.denseToSlot[dense] != slot)
+            table.freeSlots.push_back(slot);
+    }
+    table.count = count;
+    return true;
+}
+
+EntityHandle AcquireHandle(HandleTable& table) {
+    if (table.freeSlots.empty()) return nullEntity;
+
+    const uint32_t slot = table.freeSlots.back();
+    table.freeSlots.pop_back();
+    const uint32_t dense = table.count++;
+    table.slotToDense[slot]  = dense;
+    table.denseToSlot[dense] = slot;
+    return { slot, table.generation[slot] };
+}
+
+void ReleaseDense(HandleTable& table, uint32_t i) {
+    const uint32_t last = table.count - 1;
+    const uint32_t slot = table.denseToSlot[i];
+
+    if (i != last) {
+        const uint32_t moved = table.denseToSlot[last];
+        table.denseToSlot[i]     = moved;
+        table.slotToDense[moved] = i;
+    }
+    // Skip 0 on wrap-around; it marks the null handle
+    if (++table.generation[slot] == 0) table.generation[slot] = 1;
+    table.freeSlots.push_back(slot);
+    table.count--;
+}
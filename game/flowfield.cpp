@@ -0,0 +1,136 @@
+#include "flowfield.h"
+#include "game.h"
+#include <algorithm>
+#include <functional>
+
+// Orthogonal and diagonal step costs, roughly 1 : sqrt(2)
+constexpr uint32_t flowStraightCost = 10;
+constexpr uint32_t flowDiagonalCost = 14;
+
+static const int neighbourX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int neighbourZ[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// -----------------------------------------------------------------------------
+// Obstacles
+// -----------------------------------------------------------------------------
+void BuildFlowFieldObstacles(FlowField& field, const Platform* platforms, size_t count,
+                             const XZBounds& area, float clearance, float bandMinY, float bandMaxY,
+                             float cellSize) {
+    field.cellsX = 0;
+    field.cellsZ = 0;
+    field.blocked.clear();
+    field.cost.clear();
+    field.dirX.clear();
+    field.dirZ.clear();
+    field.goalX = -1;
+    field.goalZ = -1;
+    if (count == 0 || area.maxX <= area.minX || area.maxZ <= area.minZ) return;
+
+    field.cellSize    = cellSize;
+    field.invCellSize = 1.0f / cellSize;
+    field.originX = area.minX;
+    field.originZ = area.minZ;
+    field.cellsX  = std::max(1, (int)ceilf((area.maxX - area.minX) * field.invCellSize));
+    field.cellsZ  = std::max(1, (int)ceilf((area.maxZ - area.minZ) * field.invCellSize));
+
+    const size_t cellCount = (size_t)field.cellsX * field.cellsZ;
+    field.blocked.assign(cellCount, 0);
+
+    for (size_t i = 1; i < count; ++i) {
+        const Platform& p = platforms[i];
+        const float hy = p.size.y * 0.5f;
+        if (p.position.y + hy <= bandMinY || p.position.y - hy >= bandMaxY) continue;
+
+        const float minX = p.position.x - p.size.x * 0.5f - clearance;
+        const float maxX = p.position.x + p.size.x * 0.5f + clearance;
+        const float minZ = p.position.z - p.size.z * 0.5f - clearance;
+        const float maxZ = p.position.z + p.size.z * 0.5f + clearance;
+
+        // Cells whose centre falls inside the inflated footprint
+        const int c0x = std::max(0, (int)ceilf((minX - field.originX) * field.invCellSize - 0.5f));
+        const int c1x = std::min(field.cellsX - 1, (int)floorf((maxX - field.originX) * field.invCellSize - 0.5f));
+        const int c0z = std::max(0, (int)ceilf((minZ - field.originZ) * field.invCellSize - 0.5f));
+        const int c1z = std::min(field.cellsZ - 1, (int)floorf((maxZ - field.originZ) * field.invCellSize - 0.5f));
+        for (int z = c0z; z <= c1z; ++z)
+            for (int x = c0x; x <= c1x; ++x)
+                field.blocked[(size_t)z * field.cellsX + x] = 1;
+    }
+
+    // Each cell is pushed at most once per improving neighbour
+    field.open.clear();
+    field.open.reserve(cellCount * 8);
+    field.cost.assign(cellCount, flowUnreachable);
+    field.dirX.assign(cellCount, 0);
+    field.dirZ.assign(cellCount, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Distance / direction
+// -----------------------------------------------------------------------------
+// A diagonal step is allowed only when both orthogonal cells it passes are open,
+// so paths never cut an obstacle's corner
+static bool CanStep(const FlowField& field, int x, int z, int dx, int dz) {
+    const int nx = x + dx;
+    const int nz = z + dz;
+    if (nx < 0 || nz < 0 || nx >= field.cellsX || nz >= field.cellsZ) return false;
+    if (field.blocked[(size_t)nz * field.cellsX + nx]) return false;
+    if (dx != 0 && dz != 0) {
+        if (field.blocked[(size_t)z * field.cellsX + nx]) return false;
+        if (field.blocked[(size_t)nz * field.cellsX + x]) return false;
+    }
+    return true;
+}
+
+bool UpdateFlowField(FlowField& field, float goalX, float goalZ) {
+    if (field.cellsX == 0) return false;
+
+    const int gx = GridCellCoord(goalX, field.originX, field.invCellSize, field.cellsX);
+    const int gz = GridCellCoord(goalZ, field.originZ, field.invCellSize, field.cellsZ);
+    if (gx == field.goalX && gz == field.goalZ) return false;
+    field.goalX = gx;
+    field.goalZ = gz;
+    field.rebuilds++;
+
+    std::fill(field.cost.begin(), field.cost.end(), flowUnreachable);
+    std::fill(field.dirX.begin(), field.dirX.end(), (int8_t)0);
+    std::fill(field.dirZ.begin(), field.dirZ.end(), (int8_t)0);
+
+    // Dijkstra from the goal. The goal cell is seeded even when blocked (player on
+    // top of a crate) so enemies still gather around it.
+    const uint32_t maxCost = (uint32_t)(flowFieldMaxRange * field.invCellSize) * flowStraightCost;
+    auto& open = field.open;
+    open.clear();
+    const uint32_t goal = (uint32_t)(gz * field.cellsX + gx);
+    field.cost[goal] = 0;
+    open.push_back(goal);
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+        const uint64_t top = open.back();
+        open.pop_back();
+
+        const uint32_t c    = (uint32_t)top;
+        const uint32_t cost = (uint32_t)(top >> 32);
+        if (cost != field.cost[c]) continue;   // stale entry
+
+        const int x = (int)(c % field.cellsX);
+        const int z = (int)(c / field.cellsX);
+        for (int n = 0; n < 8; ++n) {
+            const int dx = neighbourX[n];
+            const int dz = neighbourZ[n];
+            if (!CanStep(field, x, z, dx, dz)) continue;
+
+            const uint32_t nc = (uint32_t)((z + dz) * field.cellsX + (x + dx));
+            const uint32_t next = cost + ((n < 4) ? flowStraightCost : flowDiagonalCost);
+            if (next >= field.cost[nc] || next > maxCost) continue;
+
+            field.cost[nc] = next;
+            // Paths are reversible, so the neighbour steps back the way we came
+            field.dirX[nc] = (int8_t)-dx;
+            field.dirZ[nc] = (int8_t)-dz;
+            open.push_back(((uint64_t)next << 32) | nc);
+            std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+        }
+    }
+    return true;
+}
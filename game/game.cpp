@@ -1,9 +1,30 @@
 #include "game.h"
+#include "assets.h"
+#include "collision.h"
+#include "render.h"
+#include "hud.h"
+#include "replay.h"
+#include "particles.h"
+#include "savestate.h"
+#include "telemetry.h"
+#include "profiler.h"
+#include "input.h"
+#include "jobs.h"
+#include "arena.h"
+#include "snapshot.h"
+#include "triplebuffer.h"
 #include "raylib.h"
 #include "raymath.h"
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <chrono>
+#include <cassert>
+#include <cfloat>
+#include <cstdio>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 // -----------------------------------------------------------------------------
 // Global / State
@@ -12,28 +33,33 @@ constexpr float gravity      = 9.81f;
 constexpr float jumpVelocity = 5.0f;
 constexpr float maxSprintTime = 10.0f;
 constexpr int maxJumpCount = 2;
+constexpr int playerSweepPasses = 3;   // contacts resolved per move (a corner takes two)
 constexpr float projectileSpeed    = 100.0f;
 constexpr float projectileRadius   = 0.01f;
 constexpr float projectileLifetime = 2.0f;
+constexpr int   projectileDamage   = 25;
+constexpr float hitscanRange       = projectileSpeed * projectileLifetime; // a round's full reach
+constexpr float hitscanSegment     = 8.0f;  // ray length per broadphase step
 constexpr int   enemyMaxHits        = 5;
 constexpr float enemyFlashDuration  = 0.1f;
 constexpr float enemyRadius         = 0.5f;
-constexpr float enemySpawnInterval  = 2.0f;
+constexpr float enemyHeight         = 2.0f;
 constexpr int   enemyMaxCount       = 10;
-
-World world = {
-    {}, // camera
-    { // platforms
-        { {0, 0, 0},     {50, 1, 50}, DARKGREEN },
-        { {0, 1.5f, 10}, { 2, 2,  2}, WHITE }
-    },
-    {}, // projectiles
-    {}, // enemies
-    0.0f // enemySpawnTimer
+constexpr float enemySeparationStrength = 0.5f; // share of an overlap each enemy resolves per tick
+constexpr size_t enemyJobGrain      = 256; // enemies per job chunk
+constexpr int   defaultTickRate     = 60;
+constexpr int   maxTicksPerFrame    = 8;   // caps catch-up after a long hitch
+
+// Built-in arena, used until a level file is loaded
+static const Platform defaultLevel[] = {
+    { {0, 0, 0},     {50, 1, 50}, DARKGREEN },
+    { {0, 1.5f, 10}, { 2, 2,  2}, WHITE }
 };
 
-Player player = {
+// Every arena's player starts from this
+static const Player defaultPlayer = {
     {}, // position
+    {}, // prevPosition
     5.0f, // speed
     5.0f, // walkSpeed
     10.0f, // runSpeed
@@ -60,7 +86,62 @@ Player player = {
     0.0f  // survivalTime
 };
 
-bool isGameOver = false;
+struct SimClock {
+    float tickDt;
+};
+
+SimClock simClock = { 1.0f / defaultTickRate };
+
+// Windowed builds tick on their own thread; the main thread keeps the window,
+// input and the GL context, and draws whatever snapshot was published last
+struct SimThread {
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> restartRequested;
+    std::atomic<bool> quickSaveRequested;
+    std::atomic<bool> quickLoadRequested;
+    std::mutex inputMutex;               // guards pendingInput; held only to copy it
+    TickInput pendingInput;
+    TripleBuffer<RenderSnapshot> snapshots;
+    std::shared_ptr<const PlatformRenderSet> platformSet;   // simulation side
+    uint64_t ticks;
+    ReplayWriter recorder;
+    bool restartPending;                 // recorded with the next tick
+};
+
+static SimThread sim;
+static const char* const quickSavePath = "quicksave.lxq";
+static char levelPath[256] = "";
+
+// -----------------------------------------------------------------------------
+// Arenas
+// -----------------------------------------------------------------------------
+static GameArena MakeArena(uint32_t seed) {
+    return { {}, defaultPlayer, WEAPON_PROJECTILE, false, enemyMaxCount, seed, MakeXoshiro(seed) };
+}
+
+// What every thread simulates unless it binds another arena
+static GameArena mainArena = MakeArena(std::random_device{}());
+static thread_local GameArena* boundArena = nullptr;
+
+GameArena& CurrentArena() {
+    return boundArena ? *boundArena : mainArena;
+}
+
+void GameBindArena(GameArena* arena) {
+    boundArena = arena;
+}
+
+GameArena* GameCreateArena(uint32_t seed) {
+    return new GameArena(MakeArena(seed));
+}
+
+void GameDestroyArena(GameArena* arena) {
+    if (!arena || arena == &mainArena) return;
+    if (boundArena == arena) boundArena = nullptr;
+    ReleaseLevel(arena->world.level);
+    delete arena;
+}
 
 // -----------------------------------------------------------------------------
 // Utility / Collision
@@ -69,161 +150,296 @@ inline float GetPlatformTopY(const Platform& p) {
     return p.position.y + p.size.y * 0.5f;
 }
 
-inline bool SphereVsAABB(const Vector3& spherePos, float r,
-                         const Vector3& boxPos, const Vector3& boxSize) {
-    const float hx = boxSize.x * 0.5f;
-    const float hy = boxSize.y * 0.5f;
-    const float hz = boxSize.z * 0.5f;
-
-    const float minX = boxPos.x - hx;
-    const float maxX = boxPos.x + hx;
-    const float minY = boxPos.y - hy;
-    const float maxY = boxPos.y + hy;
-    const float minZ = boxPos.z - hz;
-    const float maxZ = boxPos.z + hz;
-
-    const float cx = std::clamp(spherePos.x, minX, maxX);
-    const float cy = std::clamp(spherePos.y, minY, maxY);
-    const float cz = std::clamp(spherePos.z, minZ, maxZ);
-
-    const float dx = spherePos.x - cx;
-    const float dy = spherePos.y - cy;
-    const float dz = spherePos.z - cz;
-
-    return (dx*dx + dy*dy + dz*dz) <= (r * r);
-}
-
-inline void GetExpandedPlatformBounds(const Platform& p,
-                                      float& minX, float& maxX,
-                                      float& minY, float& maxY,
-                                      float& minZ, float& maxZ) {
-    const float hx = p.size.x * 0.5f + player.radius;
-    const float hy = p.size.y * 0.5f + player.radius;
-    const float hz = p.size.z * 0.5f + player.radius;
-    minX = p.position.x - hx; maxX = p.position.x + hx;
-    minY = p.position.y - hy; maxY = p.position.y + hy;
-    minZ = p.position.z - hz; maxZ = p.position.z + hz;
-}
-
-inline bool isCollidingPlatform(const Vector3& pos) {
-    for (const auto& p : world.platforms) {
-        float minX, maxX, minY, maxY, minZ, maxZ;
-        GetExpandedPlatformBounds(p, minX, maxX, minY, maxY, minZ, maxZ);
-        if (pos.x > minX && pos.x < maxX &&
-            pos.y > minY && pos.y < maxY &&
-            pos.z > minZ && pos.z < maxZ) {
-            return true;
+// Platforms the player can touch this tick: one grid query over the footprint
+// of the whole horizontal move. Vertical motion doesn't widen it.
+static void GatherPlayerContacts(const Vector3& from, const Vector3& to, FrameVector<uint32_t>& out) {
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
+    const float r = player.radius;
+    const uint32_t tested = QueryPlatformGrid(world.platformGrid,
+        std::min(from.x, to.x) - r, std::min(from.z, to.z) - r,
+        std::max(from.x, to.x) + r, std::max(from.z, to.z) + r,
+        [&](uint32_t i) {
+            out.push_back(i);
+            return false;
+        });
+    AddQueryStats(world.platformQueryStats, tested);
+}
+
+// Moves the player's sphere by delta against the gathered platforms. Each
+// contact stops the sweep on the face it hit and the rest of the move carries
+// on along it, so at most playerSweepPasses sweeps resolve a move into a
+// corner. Returns a mask of the axes (1 << axis) that blocked it.
+static int SweepPlayer(Vector3& pos, Vector3 delta, const FrameVector<uint32_t>& contacts) {
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
+    int blocked = 0;
+    for (int pass = 0; pass < playerSweepPasses; ++pass) {
+        if (fabsf(delta.x) + fabsf(delta.y) + fabsf(delta.z) < 1e-7f) break;
+
+        SweepHit first;
+        if (!FirstPlatformHit<AllPlatforms>(world.platformBounds.data(), contacts.data(), contacts.size(),
+                                            { pos, delta, player.radius }, first)) {
+            pos = Vector3Add(pos, delta);
+            break;
         }
+
+        // Stop on the face itself: the box is open there, so the next sweep
+        // slides along it without re-hitting
+        pos = Vector3Add(pos, Vector3Scale(delta, first.t));
+        delta = Vector3Scale(delta, 1.0f - first.t);
+        float* posAxis[3]   = { &pos.x, &pos.y, &pos.z };
+        float* deltaAxis[3] = { &delta.x, &delta.y, &delta.z };
+        *posAxis[first.axis]   = first.plane;
+        *deltaAxis[first.axis] = 0.0f;
+        blocked |= 1 << first.axis;
     }
-    return false;
+    return blocked;
 }
 
-inline float isOnPlatform(const Vector3& pos) {
+// Centre height when standing on one of the gathered platforms, or -1
+static float GroundHeight(const Vector3& pos, const FrameVector<uint32_t>& contacts) {
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
     constexpr float tolerance = 0.05f;
-    for (const auto& p : world.platforms) {
-        float minX, maxX, minY, maxY, minZ, maxZ;
-        GetExpandedPlatformBounds(p, minX, maxX, minY, maxY, minZ, maxZ);
-        if (pos.x > minX && pos.x < maxX &&
-            pos.z > minZ && pos.z < maxZ) {
-            const float topY  = GetPlatformTopY(p);
-            const float feetY = pos.y - player.radius;
-            if (feetY >= topY - tolerance && feetY <= topY + tolerance) {
-                return topY + player.radius;
-            }
+    const float r = player.radius;
+    const float feetY = pos.y - r;
+    for (uint32_t i : contacts) {
+        const AABB& box = world.platformBounds[i];
+        if (pos.x > box.min.x - r && pos.x < box.max.x + r &&
+            pos.z > box.min.z - r && pos.z < box.max.z + r) {
+            const float topY = box.max.y;
+            if (feetY >= topY - tolerance && feetY <= topY + tolerance)
+                return topY + r;
         }
     }
     return -1.0f;
 }
 
-inline bool ProjectileHitsPlatform(const Projectile& pr, const Platform& plat) {
-    return SphereVsAABB(pr.position, pr.radius, plat.position, plat.size);
+struct EnemyRadius { static constexpr float value = enemyRadius; };
+
+// Stats go to the caller's accumulator so enemy jobs can run this concurrently
+inline bool EnemyCollidesPlatform(const World& world, const Vector3& pos, SpatialQueryStats& stats) {
+    return AnyPlatformOverlaps<SkipFloor>(world.platformGrid, world.platformBounds.data(),
+                                          FixedSphere<EnemyRadius>{ pos }, stats);
 }
-inline bool EnemyCollidesPlatform(const Vector3& pos, float radius) {
-    // Skip the first platform (floor)
-    for (size_t i = 1; i < world.platforms.size(); ++i) {
-        const auto& p = world.platforms[i];
-        if (SphereVsAABB(pos, radius, p.position, p.size)) {
-            return true;
-        }
+
+void GameSeedRandom(uint32_t seed) {
+    GameArena& arena = CurrentArena();
+    arena.seed = seed;
+    SeedXoshiro(arena.rng, seed);
+}
+
+uint32_t GameGetSeed() {
+    return CurrentArena().seed;
+}
+
+// -----------------------------------------------------------------------------
+// Enemy spawning
+// -----------------------------------------------------------------------------
+// Positions are drawn as one batch into the frame arena, then the enemies go
+// into the pool reserved at reset, so a whole burst allocates nothing
+int SpawnEnemies(int count) {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
+    count = std::min(count, arena.enemyLimit - (int)world.enemies.size());
+    if (count <= 0) return 0;
+
+    // Only over the part of the floor that is in play (resident, when streaming)
+    const Platform& floor = world.platforms[0];
+    const XZBounds& area = world.activeBounds;
+    if (area.minX + enemyRadius >= area.maxX - enemyRadius ||
+        area.minZ + enemyRadius >= area.maxZ - enemyRadius) return 0;
+    const float y = GetPlatformTopY(floor) + enemyRadius;
+
+    FrameVector<Vector2> points((size_t)count);
+    PickSpawnPoints(world.flowField, arena.rng, area, enemyRadius, player.position.x, player.position.z,
+                    waveMinSpawnDistance, count, points.data());
+    for (const Vector2& p : points) {
+        const Vector3 pos = { p.x, y, p.y };
+        SpawnEntity(world.enemies, {
+            pos,
+            pos,
+            { 1, enemyHeight, 1 },
+            100,
+            0.0f,
+            0.0f
+        });
     }
-    return false;
-}
-
-inline bool SweptSphereVsAABB(const Vector3& start, const Vector3& end, float radius, const Vector3& boxPos, const Vector3& boxSize)
-{
-    // Expand AABB by sphere radius
-    const float hx = boxSize.x * 0.5f + radius;
-    const float hy = boxSize.y * 0.5f + radius;
-    const float hz = boxSize.z * 0.5f + radius;
-    const Vector3 min = { boxPos.x - hx, boxPos.y - hy, boxPos.z - hz };
-    const Vector3 max = { boxPos.x + hx, boxPos.y + hy, boxPos.z + hz };
-
-    // Ray vs AABB (slab method)
-    Vector3 dir = { end.x - start.x, end.y - start.y, end.z - start.z };
-    float tmin = 0.0f, tmax = 1.0f;
-    for (int i = 0; i < 3; ++i) {
-        float s = (&start.x)[i], d = (&dir.x)[i], mn = (&min.x)[i], mx = (&max.x)[i];
-        if (fabsf(d) < 1e-8f) {
-            if (s < mn || s > mx) return false;
-        }
-        else {
-            float ood = 1.0f / d;
-            float t1 = (mn - s) * ood;
-            float t2 = (mx - s) * ood;
-            if (t1 > t2) std::swap(t1, t2);
-            tmin = std::max(tmin, t1);
-            tmax = std::min(tmax, t2);
-            if (tmin > tmax) return false;
-        }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+// Levels
+// -----------------------------------------------------------------------------
+inline XZBounds GetPlatformBoundsXZ(const Platform& p) {
+    return { p.position.x - p.size.x * 0.5f, p.position.z - p.size.z * 0.5f,
+             p.position.x + p.size.x * 0.5f, p.position.z + p.size.z * 0.5f };
+}
+
+// Everything derived from the platform layout, run whenever it changes
+static void OnLevelChanged(const XZBounds& area) {
+    World& world = CurrentWorld();
+    world.platformsVersion++;
+    world.platformQueryStats = {};
+    world.activeBounds = area;
+    world.hitscan.platformMark.assign(world.platforms.size(), 0u);
+    world.platformBounds.resize(world.platforms.size());
+    for (size_t i = 0; i < world.platforms.size(); ++i)
+        world.platformBounds[i] = MakeAABB(world.platforms[i].position, world.platforms[i].size);
+
+    // Obstacles are whatever an enemy standing on the floor would walk into
+    const float floorTop = GetPlatformTopY(world.platforms[0]);
+    BuildFlowFieldObstacles(world.flowField, world.platforms.data(), world.platforms.size(), area,
+                            enemyRadius, floorTop, floorTop + enemyRadius + enemyHeight * 0.5f);
+}
+
+static void SetLevelPlatforms(std::vector<Platform> platforms, const XZBounds* clip = nullptr) {
+    World& world = CurrentWorld();
+    AllocGuardMarkUnsteady();
+    ReleaseLevel(world.level);
+    world.level.ownedPlatforms = std::move(platforms);
+    world.platforms = { world.level.ownedPlatforms.data(), world.level.ownedPlatforms.size() };
+    BuildPlatformGrid(world.platformGrid, world.platforms.data(), world.platforms.size(),
+                      platformGridCellSize, clip);
+    OnLevelChanged(clip ? *clip : GetPlatformBoundsXZ(world.platforms[0]));
+}
+
+// Swaps in the resident chunk set. Enemies left on unloaded ground go with it
+// (they don't count as defeated).
+static void ApplyStreamedPlatforms() {
+    World& world = CurrentWorld();
+    std::vector<Platform> platforms;
+    XZBounds area;
+    StreamGatherResident(platforms, area);
+
+    const XZBounds floor = GetPlatformBoundsXZ(platforms[0]);
+    area.minX = std::max(area.minX, floor.minX); area.maxX = std::min(area.maxX, floor.maxX);
+    area.minZ = std::max(area.minZ, floor.minZ); area.maxZ = std::min(area.maxZ, floor.maxZ);
+    SetLevelPlatforms(std::move(platforms), &area);
+
+    for (size_t i = 0; i < world.enemies.size();) {
+        const Vector3& pos = world.enemies[i].position;
+        if (pos.x < area.minX || pos.x > area.maxX || pos.z < area.minZ || pos.z > area.maxZ)
+            RemoveEntityAt(world.enemies, i);   // re-test the enemy swapped into i
+        else
+            ++i;
+    }
+}
+
+bool GameLoadLevel(const char* path) {
+    World& world = CurrentWorld();
+    const auto start = std::chrono::steady_clock::now();
+
+    if (IsStreamedLevel(path)) {
+        // Only the chunks around the spawn point are read before play starts
+        if (!StreamOpen(path)) return false;
+        world.platforms = {};
+    } else if (IsCompiledLevel(path)) {
+        // Platforms and the collision grid are used straight from the mapping
+        if (!MapCompiledLevel(path, world.level, world.platforms, world.platformGrid))
+            return false;
+        StreamClose();
+        OnLevelChanged(GetPlatformBoundsXZ(world.platforms[0]));
+    } else {
+        std::vector<Platform> platforms;
+        if (!ParseLevelText(path, platforms)) return false;
+        StreamClose();
+        SetLevelPlatforms(std::move(platforms));
     }
+
+    GameReset();
+    const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    TraceLog(LOG_INFO, "LEVEL: Loaded %s (%zu platforms) in %.2f ms", path, world.platforms.size(), ms);
+    snprintf(levelPath, sizeof(levelPath), "%s", path);
     return true;
 }
 
-float getRandomFloat(float min, float max) {
-    thread_local static std::mt19937 rng{ std::random_device{}() };
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
+void GameSetPlatforms(std::vector<Platform> platforms) {
+    levelPath[0] = '\0';
+    if (platforms.empty()) return;
+    StreamClose();
+    SetLevelPlatforms(std::move(platforms));
+    GameReset();
+}
+
+void GameLoadDefaultLevel() {
+    GameSetPlatforms({ std::begin(defaultLevel), std::end(defaultLevel) });
 }
 
 // -----------------------------------------------------------------------------
-// Enemy spawning
+// Audio
 // -----------------------------------------------------------------------------
-void spawnEnemy() {
-    if (world.enemies.size() >= static_cast<size_t>(enemyMaxCount)) return;
+constexpr const char* ambientMusicPath = "resources/ambient.ogg";   // streamed
+constexpr const char* killSoundPath    = "resources/coin.wav";
 
-    const Platform& floor = world.platforms[0];
-    const float minX = floor.position.x - floor.size.x * 0.5f + enemyRadius;
-    const float maxX = floor.position.x + floor.size.x * 0.5f - enemyRadius;
-    const float minZ = floor.position.z - floor.size.z * 0.5f + enemyRadius;
-    const float maxZ = floor.position.z + floor.size.z * 0.5f - enemyRadius;
-    const float y    = GetPlatformTopY(floor) + enemyRadius;
-
-    world.enemies.push_back({
-        { getRandomFloat(minX, maxX), y, getRandomFloat(minZ, maxZ) },
-        { 1, 2, 1 },
-        100,
-        0.0f,
-        0.0f
-    });
+struct GameAudio {
+    AssetHandle ambient;
+    AssetHandle kill;
+    int         kills;   // enemiesDefeated as of the last snapshot heard
+};
+static GameAudio audio = {};
+
+// Main thread, from the frame's snapshot; either sound just stays quiet until
+// (or unless) it has loaded
+static void UpdateAudio(const RenderSnapshot& snap) {
+    if (Music* ambient = GetMusic(audio.ambient)) {
+        if (!IsMusicStreamPlaying(*ambient))
+            PlayMusicStream(*ambient);
+    }
+    if (snap.enemiesDefeated > audio.kills) {
+        if (const Sound* kill = GetSound(audio.kill))
+            PlaySound(*kill);
+    }
+    audio.kills = snap.enemiesDefeated;
 }
 
 // -----------------------------------------------------------------------------
 // Lifecycle
 // -----------------------------------------------------------------------------
 void GameInit() {
-    SetConfigFlags(FLAG_VSYNC_HINT | FLAG_WINDOW_RESIZABLE);
-    InitWindow(1280, 720, "Lixtricks");
-    SetTargetFPS(144);
-    DisableCursor();
-
-    if (!world.platforms.empty()) {
-        const Platform& floor = world.platforms[0];
-        player.position = {
-            floor.position.x,
-            GetPlatformTopY(floor) + player.radius,
-            floor.position.z
-        };
+    // The window and GPU resources persist across calls
+    if (!IsWindowReady()) {
+        SetConfigFlags(FLAG_VSYNC_HINT | FLAG_WINDOW_RESIZABLE);
+        InitWindow(1280, 720, "Lixtricks");
+        SetTargetFPS(144);
+        DisableCursor();
+        InitAudioDevice();
+        InitAssets();
+        audio.ambient = AcquireMusic(ambientMusicPath);
+        audio.kill    = AcquireSound(killSoundPath);
+        InitRenderer();
+        InitParticles();
+        InitHud();
+        JobsInit();
+        ArenaInit(frameArena);
+    }
+
+    GameReset();
+}
+
+void GameReset() {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
+    AllocGuardMarkUnsteady();
+    if (StreamActive()) {
+        // Respawn at the floor centre with its surroundings already resident
+        const Platform& spawn = StreamFloor();
+        if (StreamUpdate(spawn.position.x, spawn.position.z, true) || world.platforms.empty())
+            ApplyStreamedPlatforms();
     }
+    if (world.platforms.empty())
+        SetLevelPlatforms({ std::begin(defaultLevel), std::end(defaultLevel) });
+
+    const Platform& floor = world.platforms[0];
+    player.position = {
+        floor.position.x,
+        GetPlatformTopY(floor) + player.radius,
+        floor.position.z
+    };
+    player.prevPosition = player.position;
 
     world.camera.position   = player.position;
     world.camera.target     = Vector3Add(player.position, { 0.0f, 0.0f, 1.0f });
@@ -235,49 +451,482 @@ void GameInit() {
     player.cameraYaw   = atan2f(forward.x, forward.z);
     player.cameraPitch = asinf(forward.y / Vector3Length(forward));
 
-    world.enemies.clear();
-    world.projectiles.clear();
-    world.projectiles.reserve(256);
-    world.enemies.reserve(enemyMaxCount);
-
-    world.enemySpawnTimer = 0.0f;
+    // Both pools are sized once here; handles into them stay valid until reset
+    if (world.enemies.capacity() != static_cast<size_t>(arena.enemyLimit))
+        InitEntityPool(world.enemies, (uint32_t)arena.enemyLimit);
+    else
+        ClearEntities(world.enemies);
+    world.lastHitEnemy = nullEntity;
+    InitProjectilePool(world.projectiles, projectileCapacity, projectileRadius);
+
+    HitscanState& hitscan = world.hitscan;
+    hitscan.shotCount = 0;
+    for (Tracer& tracer : hitscan.tracers) tracer.timeLeft = 0.0f;
+    hitscan.enemyMark.assign(world.enemies.capacity(), 0u);
+    ReserveEnemyGrid(world.enemyGrid, arena.enemyLimit);
+
+    ResetWaveDirector(world.waves);
     player.health = 100;
     player.enemiesDefeated = 0;
     player.shotsFired = 0;
     player.shotsHit = 0;
     player.survivalTime = 0.0f;
-    isGameOver = false;
+    arena.isGameOver = false;
+}
+
+void GameSetTickRate(int hz) {
+    if (hz <= 0) return;
+    simClock.tickDt = 1.0f / (float)hz;
+}
+
+void GameSetEnemyLimit(int limit) {
+    CurrentArena().enemyLimit = std::clamp(limit, 0, enemyLimitMax);
+}
+
+void GameSetWeaponMode(WeaponMode mode) {
+    CurrentArena().weaponMode = mode;
+}
+
+WeaponMode GameGetWeaponMode() {
+    return CurrentArena().weaponMode;
+}
+
+int GameGetTickRate() {
+    return (int)(1.0f / simClock.tickDt + 0.5f);
+}
+
+int GameGetEnemyLimit() {
+    return CurrentArena().enemyLimit;
+}
+
+bool GameIsOver() {
+    return CurrentArena().isGameOver;
 }
 
+static void StopSimulation();
+
 void GameCleanup() {
+    World& world = CurrentWorld();
+    StopSimulation();
+    TelemetryClose();
+    ReplayEndRecording(sim.recorder);
+    JobsShutdown();
+    StreamClose();
+    ArenaShutdown(frameArena);
+    ShutdownHud();
+    ShutdownParticles();
+    ShutdownRenderer();
+    ReleaseAsset(audio.ambient);
+    ReleaseAsset(audio.kill);
+    ShutdownAssets();
+    CloseAudioDevice();
+    ReleaseLevel(world.level);
+    world.platforms = {};
     CloseWindow();
 }
 
+// -----------------------------------------------------------------------------
+// Replays
+// -----------------------------------------------------------------------------
+struct StateHasher {
+    uint64_t h = 14695981039346656037ull;   // FNV-1a
+
+    void Bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    }
+    template <typename T>
+    void Value(const T& v) { Bytes(&v, sizeof(v)); }
+};
+
+uint64_t GameStateChecksum() {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
+    StateHasher hash;
+    hash.Value(player.position);
+    hash.Value(player.velocityY);
+    hash.Value(player.cameraYaw);
+    hash.Value(player.cameraPitch);
+    hash.Value(player.sprintTimer);
+    hash.Value(player.slideTimer);
+    hash.Value(player.health);
+    hash.Value(player.enemiesDefeated);
+    hash.Value(player.shotsFired);
+    hash.Value(player.shotsHit);
+    hash.Value(player.survivalTime);
+    hash.Value(arena.isGameOver);
+    hash.Value(arena.weaponMode);
+    hash.Value(world.waves.wave);
+    hash.Value(world.waves.timer);
+    hash.Value(world.waves.pending);
+
+    hash.Value(world.enemies.size());
+    for (const Enemy& e : world.enemies) {
+        hash.Value(e.position);
+        hash.Value(e.health);
+        hash.Value(e.damageCooldown);
+    }
+    const ProjectilePool& rounds = world.projectiles;
+    hash.Value(rounds.count);
+    hash.Bytes(rounds.posX.data(), rounds.count * sizeof(float));
+    hash.Bytes(rounds.posY.data(), rounds.count * sizeof(float));
+    hash.Bytes(rounds.posZ.data(), rounds.count * sizeof(float));
+    return hash.h;
+}
+
+bool GameRecordReplay(const char* path) {
+    GameArena& arena = CurrentArena();
+    ReplaySetup setup = {};
+    setup.seed             = arena.seed;
+    setup.tickRate         = GameGetTickRate();
+    setup.enemyLimit       = arena.enemyLimit;
+    setup.weaponMode       = arena.weaponMode;
+    setup.checksumInterval = replayDefaultChecksumInterval;
+    snprintf(setup.level, sizeof(setup.level), "%s", levelPath);
+    if (!ReplayBeginRecording(sim.recorder, path, setup)) return false;
+
+    // Playback starts from a freshly seeded reset, so recording does too
+    GameSeedRandom(arena.seed);
+    GameReset();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Save states
+// -----------------------------------------------------------------------------
+// Identifies the layout a state was taken on: the floor, plus the platform count
+// unless streaming (where the resident set changes as the player moves)
+static int32_t LevelFingerprint() {
+    World& world = CurrentWorld();
+    StateHasher hash;
+    const Platform& floor = StreamActive() ? StreamFloor() : world.platforms[0];
+    hash.Value(floor.position);
+    hash.Value(floor.size);
+    hash.Value(StreamActive() ? (size_t)0 : world.platforms.size());
+    return (int32_t)(hash.h ^ (hash.h >> 32));
+}
+
+void GameCaptureState(SaveState& state, uint64_t tick) {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    state.tick = tick;
+    state.globals[SAVE_GLOBAL_LEVEL]       = LevelFingerprint();
+    state.globals[SAVE_GLOBAL_SEED]        = (int32_t)arena.seed;
+    for (int i = 0; i < 4; ++i)
+        state.globals[SAVE_GLOBAL_RNG_0 + i] = (int32_t)arena.rng.s[i];
+    state.globals[SAVE_GLOBAL_WAVE]        = world.waves.wave;
+    state.globals[SAVE_GLOBAL_WAVE_TIMER]  = QuantizeValue(world.waves.timer, saveTimeStep);
+    state.globals[SAVE_GLOBAL_WAVE_PENDING] = world.waves.pending;
+    state.globals[SAVE_GLOBAL_ENEMY_LIMIT] = arena.enemyLimit;
+    state.globals[SAVE_GLOBAL_WEAPON_MODE] = arena.weaponMode;
+    state.globals[SAVE_GLOBAL_GAME_OVER]   = arena.isGameOver;
+    CaptureEntities(state, arena.player, world);
+}
+
+bool GameRestoreState(const SaveState& state) {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
+    if (state.globals[SAVE_GLOBAL_LEVEL] != LevelFingerprint()) {
+        TraceLog(LOG_WARNING, "SAVE: State from tick %llu belongs to another level",
+                 (unsigned long long)state.tick);
+        return false;
+    }
+    // The limit sizes the pools, so a corrupt or hostile file mustn't pick it
+    const int32_t enemyLimit = state.globals[SAVE_GLOBAL_ENEMY_LIMIT];
+    if (enemyLimit < 0 || enemyLimit > enemyLimitMax) {
+        TraceLog(LOG_WARNING, "SAVE: State from tick %llu has an enemy limit of %d (at most %d)",
+                 (unsigned long long)state.tick, (int)enemyLimit, enemyLimitMax);
+        return false;
+    }
+    // A wave never holds back more than the pool, nor waits longer than an interval
+    const int32_t wave      = state.globals[SAVE_GLOBAL_WAVE];
+    const int32_t pending   = state.globals[SAVE_GLOBAL_WAVE_PENDING];
+    const int32_t waveTimer = state.globals[SAVE_GLOBAL_WAVE_TIMER];
+    if (wave < 0 || pending < 0 || pending > enemyLimit ||
+        waveTimer < 0 || waveTimer > QuantizeValue(waveInterval, saveTimeStep)) {
+        TraceLog(LOG_WARNING, "SAVE: State from tick %llu has an invalid wave (%d, %d pending, timer %d)",
+                 (unsigned long long)state.tick, (int)wave, (int)pending, (int)waveTimer);
+        return false;
+    }
+    AllocGuardMarkUnsteady();
+
+    // The seed stays reported by GameGetSeed(); the stream resumes from its saved words
+    GameSeedRandom((uint32_t)state.globals[SAVE_GLOBAL_SEED]);
+    for (int i = 0; i < 4; ++i)
+        arena.rng.s[i] = (uint32_t)state.globals[SAVE_GLOBAL_RNG_0 + i];
+    world.waves.wave    = wave;
+    world.waves.timer   = DequantizeValue(waveTimer, saveTimeStep);
+    world.waves.pending = pending;
+    arena.weaponMode = state.globals[SAVE_GLOBAL_WEAPON_MODE] == WEAPON_HITSCAN ? WEAPON_HITSCAN : WEAPON_PROJECTILE;
+    arena.isGameOver = state.globals[SAVE_GLOBAL_GAME_OVER] != 0;
+
+    // Slots in the state index a pool of the limit it was taken with
+    GameSetEnemyLimit(enemyLimit);
+    if (world.enemies.capacity() != static_cast<size_t>(arena.enemyLimit)) {
+        InitEntityPool(world.enemies, (uint32_t)arena.enemyLimit);
+        world.hitscan.enemyMark.assign(world.enemies.capacity(), 0u);
+        ReserveEnemyGrid(world.enemyGrid, arena.enemyLimit);
+    }
+    world.lastHitEnemy = nullEntity;
+    world.hitscan.shotCount = 0;
+    for (Tracer& tracer : world.hitscan.tracers) tracer.timeLeft = 0.0f;
+
+    if (!RestoreEntities(state, player, world)) {
+        TraceLog(LOG_WARNING, "SAVE: State from tick %llu doesn't fit the enemy pool, resetting",
+                 (unsigned long long)state.tick);
+        GameReset();
+        return false;
+    }
+
+    // Bring the chunks around the restored position in before anything ticks
+    if (StreamActive() && StreamUpdate(player.position.x, player.position.z, true))
+        ApplyStreamedPlatforms();
+
+    const float cosPitch = cosf(player.cameraPitch);
+    const Vector3 forward = { cosPitch * sinf(player.cameraYaw), sinf(player.cameraPitch),
+                              cosPitch * cosf(player.cameraYaw) };
+    world.camera.position = player.position;
+    world.camera.target   = Vector3Add(player.position, forward);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Simulation thread
+// -----------------------------------------------------------------------------
+// The platform set only changes with the level (or resident chunks), so render
+// snapshots share one immutable copy per platformsVersion
+static void UpdatePlatformRenderSet() {
+    World& world = CurrentWorld();
+    if (sim.platformSet && sim.platformSet->version == world.platformsVersion) return;
+
+    AllocGuardMarkUnsteady();
+    auto set = std::make_shared<PlatformRenderSet>();
+    set->version = world.platformsVersion;
+    set->platforms.assign(world.platforms.begin(), world.platforms.end());
+    set->transforms.reserve(set->platforms.size());
+    for (const Platform& p : set->platforms)
+        set->transforms.push_back(PackInstance(p.position, p.size, p.colour));
+    BuildPlatformGrid(set->grid, set->platforms.data(), set->platforms.size(), platformGridCellSize,
+                      StreamActive() ? &world.activeBounds : nullptr);
+    sim.platformSet = std::move(set);
+}
+
+static void PublishSnapshot() {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
+    UpdatePlatformRenderSet();
+
+    RenderSnapshot& snap = sim.snapshots.WriteSlot();
+    snap.valid       = true;
+    snap.tick        = ++sim.ticks;
+    snap.publishedAt = std::chrono::steady_clock::now();
+    snap.tickDt      = simClock.tickDt;
+    snap.camera      = world.camera;
+    snap.eyePrev     = player.prevPosition;
+    snap.eye         = player.position;
+    snap.platforms   = sim.platformSet;
+
+    // Each slot grows to the pool capacities once, then only refills
+    if (snap.enemies.capacity() < world.enemies.capacity() ||
+        snap.rounds.capacity() < world.projectiles.capacity) {
+        AllocGuardMarkUnsteady();
+        snap.enemies.reserve(world.enemies.capacity());
+        snap.rounds.reserve(world.projectiles.capacity);
+    }
+    snap.enemies.clear();
+    for (size_t i = 0; i < world.enemies.size(); ++i) {
+        const Enemy& e = world.enemies[i];
+        snap.enemies.push_back({ EntityHandleAt(world.enemies, i), e.prevPosition, e.position, e.size,
+                                 e.flashTimer > 0.0f });
+    }
+    snap.rounds.clear();
+    for (size_t i = 0; i < world.projectiles.count; ++i)
+        snap.rounds.push_back({ GetProjectilePrevPosition(world.projectiles, i),
+                                GetProjectilePosition(world.projectiles, i) });
+    snap.roundRadius = world.projectiles.radius;
+    std::copy(std::begin(world.hitscan.tracers), std::end(world.hitscan.tracers), snap.tracers);
+
+    snap.health          = player.health;
+    snap.enemiesDefeated = player.enemiesDefeated;
+    snap.shotsFired      = player.shotsFired;
+    snap.shotsHit        = player.shotsHit;
+    snap.survivalTime    = player.survivalTime;
+    snap.weaponMode      = arena.weaponMode;
+    snap.gameOver        = arena.isGameOver;
+
+    SnapshotDebug& debug = snap.debug;
+    debug.platformQueryStats = world.platformQueryStats;
+    debug.enemyQueryStats    = world.enemyQueryStats;
+    debug.flowCellsX     = world.flowField.cellsX;
+    debug.flowCellsZ     = world.flowField.cellsZ;
+    debug.flowRebuilds   = world.flowField.rebuilds;
+    debug.enemyCapacity  = world.enemies.capacity();
+    debug.lastHitEnemy   = world.lastHitEnemy;
+    const Enemy* target  = GetEntity(world.enemies, world.lastHitEnemy);
+    debug.lastHitHealth  = target ? target->health : -1;
+    debug.streaming      = StreamActive();
+    debug.stream         = debug.streaming ? StreamGetStats() : StreamStats{};
+
+    sim.snapshots.Publish();
+}
+
+// F5 / F9, handled between ticks on the simulation thread
+static void QuickSave() {
+    AllocGuardMarkUnsteady();
+    SaveState state;
+    GameCaptureState(state, sim.ticks);
+    if (WriteSaveStateFile(quickSavePath, state))
+        TraceLog(LOG_INFO, "SAVE: Quick-saved tick %llu to %s", (unsigned long long)sim.ticks, quickSavePath);
+    else
+        TraceLog(LOG_WARNING, "SAVE: Could not write %s", quickSavePath);
+}
+
+static void QuickLoad() {
+    // The recording would no longer replay from its start
+    if (ReplayRecording(sim.recorder)) {
+        TraceLog(LOG_WARNING, "SAVE: Quick-load is disabled while recording a replay");
+        return;
+    }
+    AllocGuardMarkUnsteady();
+    SaveState state;
+    if (!ReadSaveStateFile(quickSavePath, state)) {
+        TraceLog(LOG_WARNING, "SAVE: No readable quick-save at %s", quickSavePath);
+        return;
+    }
+    if (!GameRestoreState(state)) return;
+    std::lock_guard<std::mutex> lock(sim.inputMutex);
+    sim.pendingInput = {};
+    TraceLog(LOG_INFO, "SAVE: Quick-loaded tick %llu", (unsigned long long)state.tick);
+}
+
+// Ticks at the fixed rate and publishes a snapshot after each one. After a
+// stall it runs at most maxTicksPerFrame ticks back to back, then drops the rest.
+static void SimulationThreadMain() {
+    GameArena& arena = CurrentArena();
+    using Clock = std::chrono::steady_clock;
+    ArenaInit(frameArena);
+
+    Clock::time_point nextTick = Clock::now();
+    while (sim.running.load(std::memory_order_relaxed)) {
+        const uint64_t tickAllocations = AllocGuardEndFrame();
+        if (tickAllocations > 0)
+            TraceLog(LOG_WARNING, "ALLOC: %llu heap allocations in a steady-state tick",
+                     (unsigned long long)tickAllocations);
+        assert(tickAllocations == 0 && "steady-state ticks must not touch the heap");
+        ArenaReset(frameArena);
+        AllocGuardBeginFrame();
+
+        if (sim.restartRequested.exchange(false) && arena.isGameOver) {
+            GameReset();
+            sim.restartPending = true;
+            std::lock_guard<std::mutex> lock(sim.inputMutex);
+            sim.pendingInput = {};
+        }
+        if (sim.quickSaveRequested.exchange(false))
+            QuickSave();
+        if (sim.quickLoadRequested.exchange(false))
+            QuickLoad();
+
+        if (!arena.isGameOver) {
+            TickInput input;
+            {
+                std::lock_guard<std::mutex> lock(sim.inputMutex);
+                input = sim.pendingInput;
+                ConsumeTickInput(sim.pendingInput);
+            }
+            ReplayRecordTick(sim.recorder, input, sim.restartPending);
+            sim.restartPending = false;
+            GameTick(simClock.tickDt, input);
+            if (ReplayChecksumDue(sim.recorder))
+                ReplayRecordChecksum(sim.recorder, GameStateChecksum());
+        }
+        PublishSnapshot();
+
+        const auto tickDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>(simClock.tickDt));
+        nextTick += tickDuration;
+        const Clock::time_point now = Clock::now();
+        if (now - nextTick > tickDuration * maxTicksPerFrame)
+            nextTick = now;
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    ArenaShutdown(frameArena);
+}
+
+static void StartSimulation() {
+    sim.running = true;
+    sim.thread  = std::thread(SimulationThreadMain);
+}
+
+static void StopSimulation() {
+    if (!sim.thread.joinable()) return;
+    sim.running = false;
+    sim.thread.join();
+}
+
 // -----------------------------------------------------------------------------
 // Frame Update
 // -----------------------------------------------------------------------------
 bool GameUpdate() {
-    if (isGameOver) {
-        if (IsKeyPressed(KEY_SPACE)) {
-            GameInit();
-        }
+    // The previous frame (update + draw) is over: check it, then recycle its memory
+    const uint64_t frameAllocations = AllocGuardEndFrame();
+    if (frameAllocations > 0)
+        TraceLog(LOG_WARNING, "ALLOC: %llu heap allocations in a steady-state frame",
+                 (unsigned long long)frameAllocations);
+    assert(frameAllocations == 0 && "steady-state frames must not touch the heap");
+    ArenaReset(frameArena);
+    AllocGuardBeginFrame();
+
+    ProfilerBeginFrame();
+
+    // Started on the first frame, so levels loaded after GameInit() are in place
+    if (!sim.thread.joinable())
+        StartSimulation();
+
+    if (IsKeyPressed(KEY_F3))
+        ProfilerToggleOverlay();
+    if (IsKeyPressed(KEY_F5))
+        sim.quickSaveRequested = true;
+    if (IsKeyPressed(KEY_F9))
+        sim.quickLoadRequested = true;
+
+    UpdateAssets();
+
+    // Hold the newest snapshot for this frame's GameDraw()
+    sim.snapshots.Acquire();
+    UpdateAudio(sim.snapshots.ReadSlot());
+    if (sim.snapshots.ReadSlot().gameOver) {
+        if (IsKeyPressed(KEY_SPACE))
+            sim.restartRequested = true;
         return true;
     }
 
-    const float dt = GetFrameTime();
-    player.survivalTime += dt;
-
-    world.enemySpawnTimer += dt;
-    if (world.enemySpawnTimer >= enemySpawnInterval) {
-        spawnEnemy();
-        world.enemySpawnTimer = 0.0f;
+    {
+        PROFILE_SCOPE(PHASE_INPUT);
+        std::lock_guard<std::mutex> lock(sim.inputMutex);
+        LatchLiveInput(sim.pendingInput);
     }
+    return true;
+}
 
+// -----------------------------------------------------------------------------
+// Simulation Tick
+// -----------------------------------------------------------------------------
+void UpdatePlayer(float dt, const TickInput& input) {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
     // Mouse look
-    const Vector2 mouseDelta = GetMouseDelta();
     constexpr float sensitivity = 0.003f;
-    player.cameraYaw   -= mouseDelta.x * sensitivity;
-    player.cameraPitch -= mouseDelta.y * sensitivity;
+    player.cameraYaw   -= input.mouseDelta.x * sensitivity;
+    player.cameraPitch -= input.mouseDelta.y * sensitivity;
 
     constexpr float pitchLimit = 89.0f * DEG2RAD;
     player.cameraPitch = std::clamp(player.cameraPitch, -pitchLimit, pitchLimit);
@@ -301,44 +950,26 @@ bool GameUpdate() {
 
     Vector3 nextPos = player.position;
 
-    const bool running   = IsKeyDown(KEY_LEFT_SHIFT);
-    const bool crouching = IsKeyDown(KEY_C);
+    const bool running   = input.running;
+    const bool crouching = input.crouching;
 
     const float cameraSpeed = player.speed * dt;
 
-	// Movement
-    auto tryMove = [&](const Vector3& dir, float scale) {
-        const Vector3 delta    = Vector3Scale(dir, scale);
-        Vector3 candidate      = nextPos;
-        candidate.x += delta.x;
-        candidate.z += delta.z;
-        candidate.y  = nextPos.y;
-
-        if (!isCollidingPlatform(candidate)) {
-            nextPos = candidate;
-            return;
-        }
-
-        Vector3 slideX = nextPos;
-        slideX.x += delta.x;
-        if (!isCollidingPlatform(slideX)) {
-            nextPos.x = slideX.x;
-        }
-
-        Vector3 slideZ = nextPos;
-        slideZ.z += delta.z;
-        if (!isCollidingPlatform(slideZ)) {
-            nextPos.z = slideZ.z;
-        }
-    };
+    // Movement: every held key adds to one horizontal displacement, resolved
+    // with a single sweep against the platforms gathered for it
+    Vector3 move = { 0.0f, 0.0f, 0.0f };
+    if (input.moveForward) move = Vector3Add(move, Vector3Scale(forward,  cameraSpeed));
+    if (input.moveBack)    move = Vector3Add(move, Vector3Scale(forward, -cameraSpeed));
+    if (input.moveRight)   move = Vector3Add(move, Vector3Scale(left,    -cameraSpeed));
+    if (input.moveLeft)    move = Vector3Add(move, Vector3Scale(left,     cameraSpeed));
+    move.y = 0.0f;
 
-    if (IsKeyDown(KEY_W)) tryMove(forward,  cameraSpeed);
-    if (IsKeyDown(KEY_S)) tryMove(forward, -cameraSpeed);
-    if (IsKeyDown(KEY_D)) tryMove(left,    -cameraSpeed);
-    if (IsKeyDown(KEY_A)) tryMove(left,     cameraSpeed);
+    FrameVector<uint32_t> contacts;
+    GatherPlayerContacts(nextPos, Vector3Add(nextPos, move), contacts);
+    SweepPlayer(nextPos, move, contacts);
 
     // Ground check
-    const float platformY = isOnPlatform(nextPos);
+    const float platformY = GroundHeight(nextPos, contacts);
     const bool  onGround  = platformY >= 0.0f;
 
     if (onGround && !player.wasOnGround) {
@@ -368,7 +999,7 @@ bool GameUpdate() {
     }
 
     // Jump
-    if (IsKeyPressed(KEY_SPACE) && (onGround || player.jumpCount < maxJumpCount)) {
+    if (input.jumpPressed && (onGround || player.jumpCount < maxJumpCount)) {
         player.velocityY = jumpVelocity;
         ++player.jumpCount;
     }
@@ -377,8 +1008,10 @@ bool GameUpdate() {
     if (!onGround)
         player.velocityY -= gravity * dt;
 
-    // Vertical integrate
-    nextPos.y += player.velocityY * dt;
+    // Vertical integrate, swept so a fall lands on a top however far it goes
+    // in one tick, and a jump stops under a ceiling
+    if (SweepPlayer(nextPos, { 0.0f, player.velocityY * dt, 0.0f }, contacts) & (1 << 1))
+        player.velocityY = 0.0f;
 
     // Sliding start (crouch press while running)
     const bool crouchPressed = crouching && !player.prevCrouching;
@@ -414,205 +1047,649 @@ bool GameUpdate() {
 
     player.position = nextPos;
 
-    // Fire projectile
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+    // Fire: hitscan shots are queued for UpdateProjectiles to trace as one packet
+    if (input.switchWeaponPressed)
+        arena.weaponMode = (arena.weaponMode == WEAPON_HITSCAN) ? WEAPON_PROJECTILE : WEAPON_HITSCAN;
+
+    if (input.firePressed) {
         constexpr float spawnOffset = 0.6f;
         Vector3 spawnPos = {
             player.position.x + forward.x * spawnOffset,
             player.position.y + forward.y * spawnOffset,
             player.position.z + forward.z * spawnOffset
         };
-        world.projectiles.push_back({
-            spawnPos,
-            Vector3Scale(forward, projectileSpeed),
-            projectileRadius,
-            projectileLifetime
-        });
-        player.shotsFired++;
+        HitscanState& hitscan = world.hitscan;
+        if (arena.weaponMode == WEAPON_HITSCAN) {
+            if (hitscan.shotCount < hitscanMaxShots) {
+                hitscan.shots[hitscan.shotCount++] = { spawnPos, forward };
+                PushEvent(world.events.shots, 0, { spawnPos, forward, true });
+            }
+        } else if (SpawnProjectile(world.projectiles, spawnPos,
+                                   Vector3Scale(forward, projectileSpeed), projectileLifetime) != nullEntity) {
+            PushEvent(world.events.shots, 0, { spawnPos, forward, false });
+        }
+    }
+
+    // Camera
+    world.camera.position = player.position;
+    world.camera.target   = Vector3Add(player.position, forward);
+
+    player.prevCrouching = crouching;
+    player.wasOnGround   = onGround;
+}
+
+// Hit resolution runs on the simulation thread alone, so it raises into lane 0
+static void RaiseHit(uint32_t index, const Vector3& point) {
+    World& world = CurrentWorld();
+    PushEvent(world.events.hits, 0, { index, projectileDamage, point });
+}
+
+// Where a round swept from start by delta first touches any of the boxes in
+// mask; the start when it began inside one
+static Vector3 RoundImpactPoint(const AABBBatch& batch, uint32_t mask, const Vector3& start,
+                                const Vector3& delta, float radius) {
+    float t = 1.0f;
+    while (mask) {
+        const int lane = LowestSetBit(mask);
+        SweepHit hit;
+        if (SweptSphereTimeOfImpact(start, delta, radius, GetBatchAABB(batch, lane), hit))
+            t = std::min(t, hit.t);
+        else
+            t = 0.0f;
+        mask &= mask - 1;
+    }
+    return Vector3Add(start, Vector3Scale(delta, t));
+}
+
+static void AddTracer(const Vector3& start, const Vector3& end) {
+    World& world = CurrentWorld();
+    HitscanState& hs = world.hitscan;
+    hs.tracers[hs.tracerHead] = { start, end, tracerLifetime };
+    hs.tracerHead = (hs.tracerHead + 1) % tracerCapacity;
+}
+
+// Traces every shot queued this tick as one ray packet. The packet walks out
+// from the muzzle in hitscanSegment steps; each step runs one platform and one
+// enemy grid query over the union of the live rays' segments, and every
+// candidate is tested once against all rays. A ray drops out once its nearest
+// hit lies behind the current step.
+static void ResolveHitscanShots() {
+    World& world = CurrentWorld();
+    static_assert(hitscanMaxShots <= aabbBatchSize, "hitscan shots must fit one ray packet");
+    HitscanState& hs = world.hitscan;
+    if (hs.shotCount == 0) return;
+
+    if (++hs.stamp == 0) {
+        std::fill(hs.platformMark.begin(), hs.platformMark.end(), 0u);
+        std::fill(hs.enemyMark.begin(), hs.enemyMark.end(), 0u);
+        hs.stamp = 1;
+    }
+
+    RayPacket packet = {};
+    uint32_t hitEnemy[aabbBatchSize];
+    for (int i = 0; i < hs.shotCount; ++i) {
+        PushRay(packet, hs.shots[i].origin, hs.shots[i].dir, hitscanRange);
+        hitEnemy[i] = UINT32_MAX;
+    }
+
+    float tEnter[aabbBatchSize];
+    // Lanes that hit move their tMax in, so later boxes must be nearer to win
+    auto testBox = [&](const AABB& box, uint32_t enemy) {
+        uint32_t mask = RayPacketVsAABB(packet, box.min, box.max, tEnter);
+        while (mask) {
+            const int lane = LowestSetBit(mask);
+            packet.tMax[lane] = tEnter[lane];
+            hitEnemy[lane]    = enemy;
+            mask &= mask - 1;
+        }
+    };
+
+    uint32_t platformTested = 0;
+    uint32_t enemyTested    = 0;
+    for (float segStart = 0.0f; segStart < hitscanRange; segStart += hitscanSegment) {
+        const float segEnd = std::min(segStart + hitscanSegment, hitscanRange);
+        float minX = FLT_MAX, minZ = FLT_MAX, maxX = -FLT_MAX, maxZ = -FLT_MAX;
+        for (int i = 0; i < packet.count; ++i) {
+            if (packet.tMax[i] <= segStart) continue;
+            const Vector3& o = hs.shots[i].origin;
+            const Vector3& d = hs.shots[i].dir;
+            const float t1 = std::min(segEnd, packet.tMax[i]);
+            minX = std::min(minX, std::min(o.x + d.x * segStart, o.x + d.x * t1));
+            maxX = std::max(maxX, std::max(o.x + d.x * segStart, o.x + d.x * t1));
+            minZ = std::min(minZ, std::min(o.z + d.z * segStart, o.z + d.z * t1));
+            maxZ = std::max(maxZ, std::max(o.z + d.z * segStart, o.z + d.z * t1));
+        }
+        if (minX > maxX) break;   // every ray has hit something nearer
+
+        platformTested += QueryPlatformGrid(world.platformGrid, minX, minZ, maxX, maxZ,
+            [&](uint32_t i) {
+                if (hs.platformMark[i] == hs.stamp) return false;
+                hs.platformMark[i] = hs.stamp;
+                testBox(world.platformBounds[i], UINT32_MAX);
+                return false;
+            });
+        enemyTested += QueryEnemyGrid(world.enemyGrid,
+            minX - enemyRadius, minZ - enemyRadius, maxX + enemyRadius, maxZ + enemyRadius,
+            [&](uint32_t i) {
+                if (hs.enemyMark[i] == hs.stamp) return false;
+                hs.enemyMark[i] = hs.stamp;
+                testBox(MakeAABB(world.enemies[i].position, world.enemies[i].size), i);
+                return false;
+            });
+    }
+    AddQueryStats(world.platformQueryStats, platformTested);
+    AddQueryStats(world.enemyQueryStats, enemyTested);
+
+    for (int i = 0; i < packet.count; ++i) {
+        const Vector3 end = Vector3Add(hs.shots[i].origin, Vector3Scale(hs.shots[i].dir, packet.tMax[i]));
+        if (hitEnemy[i] != UINT32_MAX)
+            RaiseHit(hitEnemy[i], end);
+        else if (packet.tMax[i] < hitscanRange)
+            PushEvent(world.events.impacts, 0, { end });
+        AddTracer(hs.shots[i].origin, end);
     }
+    hs.shotCount = 0;
+}
 
+void UpdateProjectiles(float dt) {
+    World& world = CurrentWorld();
     // Update enemy flash timers
     for (auto& enemy : world.enemies) {
         enemy.flashTimer -= dt;
         if (enemy.flashTimer < 0.0f) enemy.flashTimer = 0.0f;
     }
+    for (Tracer& tracer : world.hitscan.tracers)
+        tracer.timeLeft -= dt;
 
     // Update projectiles + collision (platform + enemies)
-    for (auto& proj : world.projectiles) {
-        if (proj.lifetime <= 0.0f) continue;
-
-        Vector3 prevPos = proj.position;
-        proj.position.x += proj.velocity.x * dt;
-        proj.position.y += proj.velocity.y * dt;
-        proj.position.z += proj.velocity.z * dt;
-        proj.lifetime   -= dt;
-        if (proj.lifetime <= 0.0f) continue;
-
-        for (const auto& plat : world.platforms) {
-            if (SweptSphereVsAABB(prevPos, proj.position, proj.radius, plat.position, plat.size)) {
-                proj.lifetime = 0.0f;
-                break;
-            }
+    ProjectilePool& projectiles = world.projectiles;
+    IntegrateProjectiles(projectiles, dt);
+    RebuildEnemyGrid(world.enemyGrid, world.enemies.data(), world.enemies.size());
+    ResolveHitscanShots();
+
+    for (size_t p = 0; p < projectiles.count; ++p) {
+        if (projectiles.lifetime[p] <= 0.0f) continue;
+
+        const Vector3 prevPos = GetProjectilePrevPosition(projectiles, p);
+        const Vector3 pos     = GetProjectilePosition(projectiles, p);
+        const float r = projectiles.radius;
+
+        // Candidates are gathered into 8-wide batches and tested with one packed sweep
+        AABBBatch batch;
+        batch.count = 0;
+        uint32_t hitMask = 0;
+        const uint32_t tested = QueryPlatformGrid(world.platformGrid,
+            std::min(prevPos.x, pos.x) - r, std::min(prevPos.z, pos.z) - r,
+            std::max(prevPos.x, pos.x) + r, std::max(prevPos.z, pos.z) + r,
+            [&](uint32_t i) {
+                PushAABB(batch, world.platformBounds[i], i);
+                if (batch.count < aabbBatchSize) return false;
+                hitMask = SweptSphereVsAABBBatch(prevPos, pos, r, batch);
+                if (hitMask == 0) batch.count = 0;
+                return hitMask != 0;
+            });
+        AddQueryStats(world.platformQueryStats, tested);
+        if (hitMask == 0 && batch.count > 0)
+            hitMask = SweptSphereVsAABBBatch(prevPos, pos, r, batch);
+        if (hitMask != 0) {
+            const Vector3 point = RoundImpactPoint(batch, hitMask, prevPos, Vector3Subtract(pos, prevPos), r);
+            PushEvent(world.events.impacts, 0, { point });
+            projectiles.lifetime[p] = 0.0f;
+            continue;
         }
-        if (proj.lifetime <= 0.0f) continue;
-
-        for (auto& enemy : world.enemies) {
-            if (SweptSphereVsAABB(prevPos, proj.position, proj.radius, enemy.position, enemy.size)) {
-                enemy.health -= 25;
-                enemy.flashTimer = enemyFlashDuration;
-                proj.lifetime = 0.0f;
-                player.shotsHit++;
-                break;
+
+        // Lowest dense index takes the hit; the hash visits candidates by cell,
+        // so keep the lowest hit index across all batches
+        uint32_t hitEnemy = UINT32_MAX;
+        auto flushEnemies = [&]() {
+            uint32_t mask = SweptSphereVsAABBBatch(prevPos, pos, r, batch);
+            while (mask) {
+                const int lane = LowestSetBit(mask);
+                hitEnemy = std::min(hitEnemy, batch.id[lane]);
+                mask &= mask - 1;
             }
+            batch.count = 0;
+        };
+        const float pad = r + enemyRadius;   // enemies are binned by centre only
+        batch.count = 0;
+        const uint32_t enemyTested = QueryEnemyGrid(world.enemyGrid,
+            std::min(prevPos.x, pos.x) - pad, std::min(prevPos.z, pos.z) - pad,
+            std::max(prevPos.x, pos.x) + pad, std::max(prevPos.z, pos.z) + pad,
+            [&](uint32_t i) {
+                PushAABB(batch, world.enemies[i].position, world.enemies[i].size, i);
+                if (batch.count == aabbBatchSize) flushEnemies();
+                return false;
+            });
+        AddQueryStats(world.enemyQueryStats, enemyTested);
+        if (batch.count > 0) flushEnemies();
+
+        if (hitEnemy != UINT32_MAX) {
+            const Enemy& enemy = world.enemies[hitEnemy];
+            const Vector3 delta = Vector3Subtract(pos, prevPos);
+            SweepHit sweep;
+            const bool entered = SweptSphereTimeOfImpact(prevPos, delta, r, MakeAABB(enemy.position, enemy.size), sweep);
+            RaiseHit(hitEnemy, entered ? Vector3Add(prevPos, Vector3Scale(delta, sweep.t)) : prevPos);
+            projectiles.lifetime[p] = 0.0f;
         }
     }
+}
 
-	// Remove dead projectiles
-    world.projectiles.erase(
-        std::remove_if(world.projectiles.begin(), world.projectiles.end(),
-                       [](const Projectile& p) { return p.lifetime <= 0.0f; }),
-        world.projectiles.end()
-	);
+void RemoveDeadEntities() {
+    World& world = CurrentWorld();
+    // Remove dead projectiles
+    RemoveDeadProjectiles(world.projectiles);
+
+    // Remove dead enemies; ApplyTickEvents() has already counted them as defeated
+    for (size_t i = 0; i < world.enemies.size();) {
+        if (world.enemies[i].health <= 0)
+            RemoveEntityAt(world.enemies, i);   // re-test the enemy swapped into i
+        else
+            ++i;
+    }
+}
 
-    // Remove dead enemies and count defeated
-    int defeatedBefore = player.enemiesDefeated;
-    size_t oldCount = world.enemies.size();
-    world.enemies.erase(
-        std::remove_if(world.enemies.begin(), world.enemies.end(),
-                       [](const Enemy& e) { return e.health <= 0; }),
-        world.enemies.end()
-    );
-    player.enemiesDefeated += (int)(oldCount - world.enemies.size());
+static void MergeQueryStats(SpatialQueryStats& into, const SpatialQueryStats& from) {
+    if (from.queries == 0) return;
+    into.queries            += from.queries;
+    into.candidatesTested   += from.candidatesTested;
+    into.lastQueryCandidates = from.lastQueryCandidates;
+}
 
+// Runs in parallel chunks. Each chunk writes only its own enemies, the
+// accumulator of the thread running it and that thread's event lanes; contact
+// damage reaches the player through the events at the end of the tick.
+void UpdateEnemies(float dt) {
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
     // --- Enemy AI movement and player damage ---
     constexpr float enemySpeed = 2.5f;
     constexpr float damageInterval = 2.0f;
     constexpr int damageAmount = 25;
 
-    for (auto& enemy : world.enemies) {
-        // Move towards player (XZ plane only)
-        Vector3 toPlayer = {
-            player.position.x - enemy.position.x,
-            0.0f,
-            player.position.z - enemy.position.z
-        };
-        float dist = Vector3Length(toPlayer);
-        if (dist > 0.01f) {
-            Vector3 dir = Vector3Scale(toPlayer, 1.0f / dist);
-            Vector3 candidate = enemy.position;
-            candidate.x += dir.x * enemySpeed * dt;
-            candidate.z += dir.z * enemySpeed * dt;
-
-            if (!EnemyCollidesPlatform(candidate, enemy.size.x * 0.5f)) {
-                enemy.position.x = candidate.x;
-                enemy.position.z = candidate.z;
+    const size_t enemyCount = world.enemies.size();
+    const Vector3 playerPos = player.position;
+    const float playerRadius = player.radius;
+
+    // Per-tick scratch lives in the frame arena
+    FrameVector<EnemyTickAccumulator> accumulators(JobsThreadCount(), EnemyTickAccumulator{});
+    UpdateFlowField(world.flowField, playerPos.x, playerPos.z);
+
+    // Seek the player
+    ParallelFor(enemyCount, enemyJobGrain, [&](size_t begin, size_t end, int thread) {
+        EnemyTickAccumulator& acc = accumulators[thread];
+        for (size_t i = begin; i < end; ++i) {
+            Enemy& enemy = world.enemies[i];
+            if (enemy.health <= 0) continue;
+
+            // Move towards player (XZ plane only), along the flow field when it
+            // has a route, straight at the player once in the same cell
+            Vector3 toPlayer = {
+                playerPos.x - enemy.position.x,
+                0.0f,
+                playerPos.z - enemy.position.z
+            };
+            float dist = Vector3Length(toPlayer);
+            if (dist > 0.01f) {
+                Vector3 dir = Vector3Scale(toPlayer, 1.0f / dist);
+                SampleFlowField(world.flowField, enemy.position.x, enemy.position.z, dir.x, dir.z);
+
+                const float step = enemySpeed * dt;
+                Vector3 candidate = enemy.position;
+                candidate.x += dir.x * step;
+                candidate.z += dir.z * step;
+
+                if (!EnemyCollidesPlatform(world, candidate, acc.platformStats)) {
+                    enemy.position.x = candidate.x;
+                    enemy.position.z = candidate.z;
+                } else {
+                    // Clipped a corner: slide along whichever axis is free
+                    const Vector3 alongX = { candidate.x, enemy.position.y, enemy.position.z };
+                    const Vector3 alongZ = { enemy.position.x, enemy.position.y, candidate.z };
+                    if (!EnemyCollidesPlatform(world, alongX, acc.platformStats))
+                        enemy.position.x = alongX.x;
+                    else if (!EnemyCollidesPlatform(world, alongZ, acc.platformStats))
+                        enemy.position.z = alongZ.z;
+                }
             }
-            // else: don't move if would collide
+
+            // Update damage cooldown
+            if (enemy.damageCooldown > 0.0f)
+                enemy.damageCooldown -= dt;
         }
+    });
 
-        // Update damage cooldown
-        if (enemy.damageCooldown > 0.0f)
-            enemy.damageCooldown -= dt;
+    // Enemy-vs-enemy separation: accumulate pushes against the moved positions, then apply
+    RebuildEnemyGrid(world.enemyGrid, world.enemies.data(), enemyCount);
+    FrameVector<Vector3> separation(enemyCount, { 0.0f, 0.0f, 0.0f });
+
+    ParallelFor(enemyCount, enemyJobGrain, [&](size_t begin, size_t end, int thread) {
+        EnemyTickAccumulator& acc = accumulators[thread];
+        for (size_t i = begin; i < end; ++i) {
+            const Enemy& a = world.enemies[i];
+            if (a.health <= 0) continue;
+            const float ra = a.size.x * 0.5f;
+            const float reach = ra + enemyRadius;
+            Vector3& push = separation[i];
+
+            const uint32_t tested = QueryEnemyGrid(world.enemyGrid,
+                a.position.x - reach, a.position.z - reach, a.position.x + reach, a.position.z + reach,
+                [&](uint32_t j) {
+                    if (j == i) return false;
+                    const Enemy& b = world.enemies[j];
+                    if (b.health <= 0) return false;
+                    const float dx = a.position.x - b.position.x;
+                    const float dz = a.position.z - b.position.z;
+                    const float minDist = ra + b.size.x * 0.5f;
+                    const float distSq  = dx*dx + dz*dz;
+                    if (distSq >= minDist * minDist || distSq < 1e-8f) return false;
+
+                    const float d = sqrtf(distSq);
+                    const float overlap = (minDist - d) * enemySeparationStrength;
+                    push.x += dx / d * overlap;
+                    push.z += dz / d * overlap;
+                    return false;
+                });
+            AddQueryStats(acc.enemyStats, tested);
+        }
+    });
 
-        // Check collision with player (sphere vs sphere)
-        float combinedRadius = player.radius + enemy.size.x * 0.5f;
-        Vector3 diff = {
-            player.position.x - enemy.position.x,
-            player.position.y - enemy.position.y,
-            player.position.z - enemy.position.z
-        };
-        float distToPlayer = Vector3Length(diff);
-        if (distToPlayer < combinedRadius) {
-            if (enemy.damageCooldown <= 0.0f) {
-                player.health -= damageAmount;
-                if (player.health < 0) player.health = 0;
+    // Apply separation, then check contact with the player (sphere vs sphere)
+    // against the final position. Each enemy tests only itself, which is O(1)
+    // per enemy and needs no shared query around the player.
+    ParallelFor(enemyCount, enemyJobGrain, [&](size_t begin, size_t end, int thread) {
+        EnemyTickAccumulator& acc = accumulators[thread];
+        for (size_t i = begin; i < end; ++i) {
+            Enemy& enemy = world.enemies[i];
+            if (enemy.health <= 0) continue;
+
+            const Vector3& push = separation[i];
+            if (push.x != 0.0f || push.z != 0.0f) {
+                const Vector3 candidate = { enemy.position.x + push.x, enemy.position.y, enemy.position.z + push.z };
+                if (!EnemyCollidesPlatform(world, candidate, acc.platformStats)) {
+                    enemy.position.x = candidate.x;
+                    enemy.position.z = candidate.z;
+                }
+            }
+
+            const float combinedRadius = playerRadius + enemy.size.x * 0.5f;
+            const float distToPlayer = Vector3Distance(playerPos, enemy.position);
+            if (distToPlayer < combinedRadius && enemy.damageCooldown <= 0.0f) {
+                PushEvent(world.events.playerDamage, thread, { (uint32_t)i, damageAmount });
                 enemy.damageCooldown = damageInterval;
             }
         }
+    });
+
+    // Reduce
+    for (const EnemyTickAccumulator& acc : accumulators) {
+        MergeQueryStats(world.platformQueryStats, acc.platformStats);
+        MergeQueryStats(world.enemyQueryStats, acc.enemyStats);
     }
+}
 
-    if (player.health <= 0) {
-        isGameOver = true;
+// Applies everything the tick raised, one event type at a time. Hits run
+// before kills because they raise them. The visible side (sparks, bursts) is
+// handed to the particle system in one batch.
+static void ApplyTickEvents() {
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
+    TickEvents& events = world.events;
+    FrameVector<ParticleEmit> emits;
+
+    ConsumeEvents(events.shots, [&](const ShotFiredEvent&) {
+        player.shotsFired++;
+    });
+
+    ConsumeEvents(events.hits, [&](const HitEvent& hit) {
+        Enemy& enemy = world.enemies[hit.enemy];
+        const bool wasAlive = enemy.health > 0;
+        enemy.health    -= hit.damage;
+        enemy.flashTimer = enemyFlashDuration;
+        world.lastHitEnemy = EntityHandleAt(world.enemies, hit.enemy);
+        player.shotsHit++;
+        if (wasAlive && enemy.health <= 0)
+            PushEvent(events.kills, 0, { world.lastHitEnemy, enemy.position });
+        emits.push_back({ hit.point, PARTICLE_SPARK });
+    });
+
+    ConsumeEvents(events.impacts, [&](const ImpactEvent& impact) {
+        emits.push_back({ impact.point, PARTICLE_SPARK });
+    });
+
+    ConsumeEvents(events.kills, [&](const KillEvent& kill) {
+        player.enemiesDefeated++;
+        emits.push_back({ kill.position, PARTICLE_BURST });
+    });
+
+    ConsumeEvents(events.playerDamage, [&](const PlayerDamagedEvent& damage) {
+        player.health -= damage.damage;
+    });
+    if (player.health < 0) player.health = 0;
+
+    QueueParticleEmits(emits.data(), emits.size());
+}
+
+// -----------------------------------------------------------------------------
+// Telemetry
+// -----------------------------------------------------------------------------
+// Sums over the ticks since the last sample; only kept while a sink is open
+struct TelemetryWindow {
+    uint64_t tick;          // ticks run with a sink open
+    int      ticks;
+    float    tickMs;
+    float    tickMsMax;
+    uint64_t allocations;
+};
+
+static TelemetryWindow telemetryWindow;
+
+static void SampleTelemetry(float tickMs, uint64_t allocations) {
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
+    TelemetryWindow& w = telemetryWindow;
+    w.tick++;
+    w.ticks++;
+    w.tickMs += tickMs;
+    w.tickMsMax = std::max(w.tickMsMax, tickMs);
+    w.allocations += allocations;
+    if (w.ticks < telemetrySampleTicks) return;
+
+    float phaseMs[PHASE_COUNT];
+    ProfilerTakeThreadTotals(phaseMs);
+
+    TelemetrySample sample = {};
+    sample.tick            = w.tick;
+    sample.health          = player.health;
+    sample.enemiesDefeated = player.enemiesDefeated;
+    sample.shotsFired      = player.shotsFired;
+    sample.shotsHit        = player.shotsHit;
+    sample.survivalTime    = player.survivalTime;
+    sample.wave            = world.waves.wave;
+    sample.enemies         = (uint32_t)world.enemies.size();
+    sample.rounds          = world.projectiles.count;
+    sample.tickMs          = w.tickMs / (float)w.ticks;
+    sample.tickMsMax       = w.tickMsMax;
+    for (int p = 0; p < telemetryPhaseCount; ++p)
+        sample.phaseMs[p] = phaseMs[telemetryFirstPhase + p] / (float)w.ticks;
+    sample.allocations     = w.allocations;
+    TelemetrySubmit(sample);
+
+    w = { w.tick, 0, 0.0f, 0.0f, 0 };
+}
+
+static void RunTick(float dt, const TickInput& input) {
+    GameArena& arena = CurrentArena();
+    World& world = arena.world;
+    Player& player = arena.player;
+    const int lanes = JobsThreadCount();
+    PrepareEventQueue(world.events.shots, lanes);
+    PrepareEventQueue(world.events.hits, lanes);
+    PrepareEventQueue(world.events.impacts, lanes);
+    PrepareEventQueue(world.events.kills, lanes);
+    PrepareEventQueue(world.events.playerDamage, lanes);
+
+    // Snapshot positions for render interpolation
+    player.prevPosition = player.position;
+    for (auto& enemy : world.enemies)
+        enemy.prevPosition = enemy.position;
+
+    player.survivalTime += dt;
+
+    if (StreamActive()) {
+        PROFILE_SCOPE(PHASE_STREAMING);
+        if (StreamUpdate(player.position.x, player.position.z, false))
+            ApplyStreamedPlatforms();
+    }
+    {
+        PROFILE_SCOPE(PHASE_SPAWN);
+        SpawnEnemies(StepWaveDirector(world.waves, dt, arena.enemyLimit - (int)world.enemies.size()));
+    }
+    {
+        PROFILE_SCOPE(PHASE_PLAYER);
+        UpdatePlayer(dt, input);
+    }
+    {
+        PROFILE_SCOPE(PHASE_PROJECTILES);
+        UpdateProjectiles(dt);
+    }
+    {
+        PROFILE_SCOPE(PHASE_ENEMIES);
+        UpdateEnemies(dt);
+    }
+    {
+        PROFILE_SCOPE(PHASE_EVENTS);
+        ApplyTickEvents();
+    }
+    {
+        PROFILE_SCOPE(PHASE_COMPACTION);
+        RemoveDeadEntities();
     }
 
-    // Camera
-    world.camera.position = player.position;
-    world.camera.target   = Vector3Add(player.position, forward);
+    if (player.health <= 0) {
+        arena.isGameOver = true;
+    }
+}
 
-    player.prevCrouching = crouching;
-    player.wasOnGround   = onGround;
-    return true;
+void GameTick(float dt, const TickInput& input) {
+    if (!TelemetryActive()) {
+        RunTick(dt, input);
+        return;
+    }
+    // A window's phase totals start with its first tick
+    if (telemetryWindow.ticks == 0) {
+        float discard[PHASE_COUNT];
+        ProfilerTakeThreadTotals(discard);
+    }
+    const uint64_t allocationsBefore = ThreadHeapAllocations();
+    const auto start = std::chrono::steady_clock::now();
+    RunTick(dt, input);
+    const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    SampleTelemetry(ms, ThreadHeapAllocations() - allocationsBefore);
 }
 
 // -----------------------------------------------------------------------------
 // Draw
 // -----------------------------------------------------------------------------
 void GameDraw() {
+    const RenderSnapshot& snap = sim.snapshots.ReadSlot();
+
     BeginDrawing();
     ClearBackground(SKYBLUE);
+    if (!snap.valid) {
+        EndDrawing();
+        return;
+    }
 
     // Calculate score and accuracy
-    int score = player.enemiesDefeated * 100;
-    float accuracy = (player.shotsFired > 0) ? (float)player.shotsHit / player.shotsFired : 0.0f;
+    int score = snap.enemiesDefeated * 100;
+    float accuracy = (snap.shotsFired > 0) ? (float)snap.shotsHit / snap.shotsFired : 0.0f;
     int finalScore = (int)(score + score * accuracy);
 
-    if (isGameOver) {
-        // Game Over Screen
-        const char* msg = "GAME OVER";
-        const char* restartMsg = "Press SPACE to restart";
-        int screenWidth = GetScreenWidth();
-        int screenHeight = GetScreenHeight();
-        int msgWidth = MeasureText(msg, 64);
-        int restartWidth = MeasureText(restartMsg, 32);
-
-        DrawText(msg, (screenWidth - msgWidth) / 2, screenHeight / 2 - 120, 64, RED);
-        DrawText(restartMsg, (screenWidth - restartWidth) / 2, screenHeight / 2 - 40, 32, RAYWHITE);
-
-        DrawText(TextFormat("Score: %d", finalScore), screenWidth / 2 - 100, screenHeight / 2 + 20, 32, YELLOW);
-        DrawText(TextFormat("Enemies Defeated: %d", player.enemiesDefeated), screenWidth / 2 - 100, screenHeight / 2 + 60, 24, RAYWHITE);
-        DrawText(TextFormat("Accuracy: %.1f%%", accuracy * 100.0f), screenWidth / 2 - 100, screenHeight / 2 + 90, 24, RAYWHITE);
-        DrawText(TextFormat("Survival Time: %.1fs", player.survivalTime), screenWidth / 2 - 100, screenHeight / 2 + 120, 24, RAYWHITE);
-
+    HudState hudState = {};
+    hudState.screenWidth     = GetScreenWidth();
+    hudState.screenHeight    = GetScreenHeight();
+    hudState.gameOver        = snap.gameOver;
+    hudState.health          = snap.health;
+    hudState.score           = finalScore;
+    hudState.enemiesDefeated = snap.enemiesDefeated;
+    hudState.accuracyTenths  = (int)(accuracy * 1000.0f + 0.5f);
+    hudState.survivalTenths  = (int)(snap.survivalTime * 10.0f + 0.5f);
+    hudState.hitscan         = snap.weaponMode == WEAPON_HITSCAN;
+
+    if (snap.gameOver) {
+        DrawHud(hudState);
         EndDrawing();
         return;
     }
 
-    BeginMode3D(world.camera);
-
-    for (const auto& p : world.platforms)
-        DrawCube(p.position, p.size.x, p.size.y, p.size.z, p.colour);
-
-    for (const auto& e : world.enemies) {
-        const Color col = (e.flashTimer > 0.0f) ? RED : DARKPURPLE;
-        DrawCube(e.position, e.size.x, e.size.y, e.size.z, col);
+    // Render state sits between the start and end of the snapshot's tick, by how
+    // far the clock has moved past it
+    const float sinceTick = std::chrono::duration<float>(std::chrono::steady_clock::now() - snap.publishedAt).count();
+    const float alpha = Clamp(sinceTick / snap.tickDt, 0.0f, 1.0f);
+    Camera3D camera = snap.camera;
+    const Vector3 look = Vector3Subtract(snap.camera.target, snap.camera.position);
+    camera.position = Vector3Lerp(snap.eyePrev, snap.eye, alpha);
+    camera.target   = Vector3Add(camera.position, look);
+
+    {
+        PROFILE_SCOPE(PHASE_DRAW_WORLD);
+        BeginMode3D(camera);
+        DrawWorldInstanced(snap, camera, alpha);
+        DrawParticles();
+        EndMode3D();
     }
 
-    for (const auto& p : world.projectiles)
-        DrawSphere(p.position, p.radius, YELLOW);
-
-    EndMode3D();
-
-    const int screenWidth  = GetScreenWidth();
-    const int screenHeight = GetScreenHeight();
-    const int cx = screenWidth / 2;
-    const int cy = screenHeight / 2;
-    const int crosshairSize = 12;
-    const int crosshairThickness = 2;
-
-    DrawRectangle(cx - crosshairSize / 2,  cy - crosshairThickness / 2,
-                  crosshairSize,           crosshairThickness, RAYWHITE);
-    DrawRectangle(cx - crosshairThickness / 2, cy - crosshairSize / 2,
-                  crosshairThickness,         crosshairSize,   RAYWHITE);
-
-    DrawText("Lixtricks", 10, 10, 12, RAYWHITE);
-    DrawFPS(10, 30);
-
-    DrawText(TextFormat("Health: %d", player.health), 10, 50, 20, RED);
+    {
+        PROFILE_SCOPE(PHASE_DRAW_HUD);
+        DrawHud(hudState);
+    }
 
-    DrawText(TextFormat("Score: %d", finalScore), 10, 80, 20, YELLOW);
-    DrawText(TextFormat("Enemies Defeated: %d", player.enemiesDefeated), 10, 110, 20, RAYWHITE);
-    DrawText(TextFormat("Accuracy: %.1f%%", accuracy * 100.0f), 10, 140, 20, RAYWHITE);
-    DrawText(TextFormat("Survival Time: %.1fs", player.survivalTime), 10, 170, 20, RAYWHITE);
+    const int screenWidth = hudState.screenWidth;
+    if (ProfilerOverlayVisible()) {
+        const RenderStats& rs = renderer.stats;
+        const SnapshotDebug& debug = snap.debug;
+        DrawProfilerOverlay(screenWidth - 340, 10);
+        DrawText(FrameFormat("draws %d | platforms %d (-%d) | enemies %d+%d (-%d) | rounds %d (-%d) | tracers %d",
+                            rs.drawCalls, rs.platformInstances, rs.platformsCulled,
+                            rs.enemyInstances, rs.enemyImpostors, rs.enemiesCulled,
+                            rs.projectileInstances, rs.projectilesCulled, rs.tracers),
+                 screenWidth - 340, 250, 10, RAYWHITE);
+        DrawText(FrameFormat("broadphase: platforms %.1f / enemies %.1f candidates per query",
+                            debug.platformQueryStats.queries
+                                ? (double)debug.platformQueryStats.candidatesTested / debug.platformQueryStats.queries : 0.0,
+                            debug.enemyQueryStats.queries
+                                ? (double)debug.enemyQueryStats.candidatesTested / debug.enemyQueryStats.queries : 0.0),
+                 screenWidth - 340, 264, 10, RAYWHITE);
+        DrawText(FrameFormat("flow field: %dx%d cells | %llu rebuilds",
+                            debug.flowCellsX, debug.flowCellsZ,
+                            (unsigned long long)debug.flowRebuilds),
+                 screenWidth - 340, 278, 10, RAYWHITE);
+        DrawText(FrameFormat("pools: %zu/%zu enemies | %zu rounds | last hit #%u.%u %s",
+                            snap.enemies.size(), debug.enemyCapacity, snap.rounds.size(),
+                            debug.lastHitEnemy.slot, debug.lastHitEnemy.generation,
+                            debug.lastHitHealth >= 0 ? FrameFormat("hp %d", debug.lastHitHealth) : "gone"),
+                 screenWidth - 340, 292, 10, RAYWHITE);
+        if (debug.streaming) {
+            const StreamStats& ss = debug.stream;
+            DrawText(FrameFormat("stream: %d chunks (+%d pending) | %zu platforms | %llu in / %llu out",
+                                ss.residentChunks, ss.pendingChunks, ss.residentPlatforms,
+                                (unsigned long long)ss.loads, (unsigned long long)ss.unloads),
+                     screenWidth - 340, 306, 10, RAYWHITE);
+        }
+        DrawText(FrameFormat("sim tick %llu | hud redraws %llu",
+                            (unsigned long long)snap.tick, (unsigned long long)hud.redraws),
+                 screenWidth - 340, 320, 10, RAYWHITE);
+        const ParticleStats ps = GetParticleStats();
+        DrawText(FrameFormat("particles: %d bursts resident | %d drawn | %llu emitted (%llu dropped)",
+                            ps.resident, ps.instances, (unsigned long long)ps.emitted,
+                            (unsigned long long)ps.dropped),
+                 screenWidth - 340, 334, 10, RAYWHITE);
+        const AssetStats as = GetAssetStats();
+        DrawText(FrameFormat("assets: %d ready (+%d queued, %d failed) | %zu KB decoded | %llu uploads",
+                            as.ready, as.queued, as.failed, as.decodedBytes / 1024,
+                            (unsigned long long)as.uploads),
+                 screenWidth - 340, 348, 10, RAYWHITE);
+    }
 
     EndDrawing();
-}
\ No newline at end of file
+}
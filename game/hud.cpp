@@ -0,0 +1,103 @@
+#include "hud.h"
+#include "arena.h"
+
+Hud hud = {};
+
+// -----------------------------------------------------------------------------
+// Lifecycle
+// -----------------------------------------------------------------------------
+void InitHud() {
+    hud = {};
+}
+
+void ShutdownHud() {
+    if (hud.target.id != 0) UnloadRenderTexture(hud.target);
+    hud = {};
+}
+
+// -----------------------------------------------------------------------------
+// Rasterization
+// -----------------------------------------------------------------------------
+static bool SameHudState(const HudState& a, const HudState& b) {
+    return a.screenWidth == b.screenWidth && a.screenHeight == b.screenHeight &&
+           a.gameOver == b.gameOver && a.health == b.health && a.score == b.score &&
+           a.enemiesDefeated == b.enemiesDefeated && a.accuracyTenths == b.accuracyTenths &&
+           a.survivalTenths == b.survivalTenths && a.hitscan == b.hitscan;
+}
+
+static void RasterizeGameOver(const HudState& s) {
+    const char* msg = "GAME OVER";
+    const char* restartMsg = "Press SPACE to restart";
+    const int screenWidth  = s.screenWidth;
+    const int screenHeight = s.screenHeight;
+    const int msgWidth     = MeasureText(msg, 64);
+    const int restartWidth = MeasureText(restartMsg, 32);
+
+    DrawText(msg, (screenWidth - msgWidth) / 2, screenHeight / 2 - 120, 64, RED);
+    DrawText(restartMsg, (screenWidth - restartWidth) / 2, screenHeight / 2 - 40, 32, RAYWHITE);
+
+    DrawText(FrameFormat("Score: %d", s.score), screenWidth / 2 - 100, screenHeight / 2 + 20, 32, YELLOW);
+    DrawText(FrameFormat("Enemies Defeated: %d", s.enemiesDefeated), screenWidth / 2 - 100, screenHeight / 2 + 60, 24, RAYWHITE);
+    DrawText(FrameFormat("Accuracy: %.1f%%", s.accuracyTenths * 0.1f), screenWidth / 2 - 100, screenHeight / 2 + 90, 24, RAYWHITE);
+    DrawText(FrameFormat("Survival Time: %.1fs", s.survivalTenths * 0.1f), screenWidth / 2 - 100, screenHeight / 2 + 120, 24, RAYWHITE);
+}
+
+static void RasterizePlaying(const HudState& s) {
+    const int cx = s.screenWidth / 2;
+    const int cy = s.screenHeight / 2;
+    const int crosshairSize = 12;
+    const int crosshairThickness = 2;
+
+    DrawRectangle(cx - crosshairSize / 2,  cy - crosshairThickness / 2,
+                  crosshairSize,           crosshairThickness, RAYWHITE);
+    DrawRectangle(cx - crosshairThickness / 2, cy - crosshairSize / 2,
+                  crosshairThickness,         crosshairSize,   RAYWHITE);
+
+    DrawText("Lixtricks", 10, 10, 12, RAYWHITE);
+    // Same look as DrawFPS(), from the sampled value
+    const Color fpsColour = (hud.fps < 15) ? RED : (hud.fps < 30) ? ORANGE : LIME;
+    DrawText(FrameFormat("%2i FPS", hud.fps), 10, 30, 20, fpsColour);
+
+    DrawText(FrameFormat("Health: %d", s.health), 10, 50, 20, RED);
+
+    DrawText(FrameFormat("Score: %d", s.score), 10, 80, 20, YELLOW);
+    DrawText(FrameFormat("Enemies Defeated: %d", s.enemiesDefeated), 10, 110, 20, RAYWHITE);
+    DrawText(FrameFormat("Accuracy: %.1f%%", s.accuracyTenths * 0.1f), 10, 140, 20, RAYWHITE);
+    DrawText(FrameFormat("Survival Time: %.1fs", s.survivalTenths * 0.1f), 10, 170, 20, RAYWHITE);
+    DrawText(s.hitscan ? "Weapon: Hitscan [Q]" : "Weapon: Rounds [Q]", 10, 200, 20, RAYWHITE);
+}
+
+void DrawHud(const HudState& state) {
+    bool dirty = !hud.valid || !SameHudState(state, hud.shown);
+
+    const double now = GetTime();
+    if (now - hud.fpsSampledAt >= hudFpsInterval) {
+        const int fps = GetFPS();
+        dirty = dirty || (fps != hud.fps && !state.gameOver);
+        hud.fps = fps;
+        hud.fpsSampledAt = now;
+    }
+
+    if (dirty) {
+        if (hud.target.id == 0 || hud.target.texture.width != state.screenWidth ||
+            hud.target.texture.height != state.screenHeight) {
+            AllocGuardMarkUnsteady();
+            if (hud.target.id != 0) UnloadRenderTexture(hud.target);
+            hud.target = LoadRenderTexture(state.screenWidth, state.screenHeight);
+        }
+
+        BeginTextureMode(hud.target);
+        ClearBackground(BLANK);
+        if (state.gameOver) RasterizeGameOver(state);
+        else                RasterizePlaying(state);
+        EndTextureMode();
+
+        hud.shown = state;
+        hud.valid = true;
+        hud.redraws++;
+    }
+
+    // Render textures are stored bottom-up
+    const Rectangle source = { 0.0f, 0.0f, (float)hud.target.texture.width, -(float)hud.target.texture.height };
+    DrawTextureRec(hud.target.texture, source, { 0.0f, 0.0f }, WHITE);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Heap block taken when the arena is full; freed with the alignment it was allocated with
+struct ArenaOverflowBlock {
+    void*  p;
+    size_t align;
+};
+
+// Per-frame linear allocator. Everything allocated from it is released at once
+// by ArenaReset() at the top of each frame, so transient collections cost a
+// pointer bump and never touch the heap. The render thread resets its arena per
+// frame and the simulation thread per tick (as does the headless runner); job
+// chunks may write into arena memory they are handed but don't allocate.
+struct FrameArena {
+    uint8_t* base;
+    size_t   capacity;
+    size_t   offset;
+    size_t   peak;                   // high-water mark across frames
+    size_t   overflowBytes;          // this frame's allocations that didn't fit
+    std::vector<ArenaOverflowBlock> overflow;   // heap fallbacks, freed at the next reset
+};
+
+constexpr size_t frameArenaDefaultSize = 32u << 20;
+
+// One per thread; each thread that allocates from it calls ArenaInit()
+extern thread_local FrameArena frameArena;
+
+void  ArenaInit(FrameArena& arena, size_t capacity = frameArenaDefaultSize);
+void  ArenaShutdown(FrameArena& arena);
+void  ArenaReset(FrameArena& arena);
+void* ArenaAlloc(FrameArena& arena, size_t bytes, size_t align = alignof(std::max_align_t));
+
+// printf into frame memory; like TextFormat() without the fixed buffer count
+const char* FrameFormat(const char* fmt, ...);
+
+// STL adapter: deallocate is a no-op, memory comes back at ArenaReset()
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    FrameArena* arena;
+
+    ArenaAllocator() : arena(&frameArena) {}
+    explicit ArenaAllocator(FrameArena& a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(ArenaAlloc(*arena, n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// -----------------------------------------------------------------------------
+// Allocation guard: counts global operator new calls on the calling thread and
+// flags steady-state frames that hit the heap. Each thread keeps its own frame
+// count and exemptions. On in Debug, or with LIX_ALLOC_TRACKING in any build.
+// -----------------------------------------------------------------------------
+#if !defined(NDEBUG) && !defined(LIX_ALLOC_TRACKING)
+    #define LIX_ALLOC_TRACKING 1
+#endif
+
+#if defined(LIX_ALLOC_TRACKING)
+
+constexpr int allocGuardWarmupFrames = 60;
+
+uint64_t ThreadHeapAllocations();
+void     AllocGuardBeginFrame();
+// Work that legitimately allocates (level changes, restarts, chunk streaming)
+// exempts the current and the next frame
+void     AllocGuardMarkUnsteady();
+// Heap allocations made since AllocGuardBeginFrame(), or 0 for exempt frames
+uint64_t AllocGuardEndFrame();
+
+#else
+
+inline uint64_t ThreadHeapAllocations() { return 0; }
+inline void     AllocGuardBeginFrame() {}
+inline void     AllocGuardMarkUnsteady() {}
+inline uint64_t AllocGuardEndFrame() { return 0; }
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+
+// Asset manager. Textures and sounds decode on loader threads (LoadImage and
+// LoadWave are plain CPU work); the GPU or audio-device half of each load runs
+// in UpdateAssets() on the main thread, as many per frame as fit in the upload
+// budget. Music is opened as a stream and never decoded whole. Decoded data
+// waiting for upload is capped at assetDecodedLimit, so a burst of requests
+// can't balloon memory.
+//
+// Handles are ref-counted: acquiring a path that is already loaded (or on its
+// way) shares the entry, and the last release unloads it. Everything here is
+// main-thread only.
+
+enum AssetType : uint8_t {
+    ASSET_TEXTURE = 0,
+    ASSET_SOUND,
+    ASSET_MUSIC
+};
+
+enum AssetState : uint8_t {
+    ASSET_FREE = 0,
+    ASSET_QUEUED,        // decoding, or waiting for its upload
+    ASSET_READY,
+    ASSET_FAILED
+};
+
+struct AssetHandle {
+    uint32_t slot;
+    uint32_t generation;    // 0 never names an asset
+};
+
+constexpr AssetHandle nullAsset = { 0, 0 };
+
+constexpr int    assetSlotCount      = 64;
+constexpr int    assetLoaderThreads  = 2;
+constexpr double assetUploadBudgetMs = 2.0;          // main-thread upload time per frame
+constexpr size_t assetDecodedLimit   = 64u << 20;    // decoded bytes waiting for upload
+
+struct AssetStats {
+    int      ready;
+    int      queued;
+    int      failed;
+    size_t   decodedBytes;
+    uint64_t uploads;
+};
+
+// After InitWindow() and InitAudioDevice(); shutdown unloads whatever is still
+// held and must run before either is closed
+void InitAssets();
+void ShutdownAssets();
+
+AssetHandle AcquireTexture(const char* path);
+AssetHandle AcquireSound(const char* path);
+AssetHandle AcquireMusic(const char* path);
+// Drops one reference and nulls the handle
+void ReleaseAsset(AssetHandle& handle);
+
+AssetState GetAssetState(AssetHandle handle);
+
+// nullptr until the asset is ready (or after it failed or was released)
+const Texture2D* GetTexture(AssetHandle handle);
+const Sound*     GetSound(AssetHandle handle);
+Music*           GetMusic(AssetHandle handle);
+
+// Once per frame: finishes decoded loads within the budget, opens queued music
+// streams and keeps every playing stream fed
+void UpdateAssets(double budgetMs = assetUploadBudgetMs);
+
+AssetStats GetAssetStats();
@@ -0,0 +1,333 @@
+#pragma once
+#include "raylib.h"
+#include "simd.h"
+#include "spatial.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Scalar kernels
+// -----------------------------------------------------------------------------
+// Box with its extents worked out once, e.g. per platform when the level loads
+struct AABB {
+    Vector3 min;
+    Vector3 max;
+};
+
+inline AABB MakeAABB(const Vector3& pos, const Vector3& size) {
+    return { { pos.x - size.x * 0.5f, pos.y - size.y * 0.5f, pos.z - size.z * 0.5f },
+             { pos.x + size.x * 0.5f, pos.y + size.y * 0.5f, pos.z + size.z * 0.5f } };
+}
+
+inline bool SphereVsAABB(const Vector3& spherePos, float r, const AABB& box) {
+    // Clamping by value keeps this to min/max instructions; std::clamp on
+    // references into a bounds array compiles to branches on the loads
+    const AABB b = box;
+    const float cx = std::clamp(spherePos.x, b.min.x, b.max.x);
+    const float cy = std::clamp(spherePos.y, b.min.y, b.max.y);
+    const float cz = std::clamp(spherePos.z, b.min.z, b.max.z);
+
+    const float dx = spherePos.x - cx;
+    const float dy = spherePos.y - cy;
+    const float dz = spherePos.z - cz;
+
+    return (dx*dx + dy*dy + dz*dz) <= (r * r);
+}
+
+inline bool SweptSphereVsAABB(const Vector3& start, const Vector3& end, float radius, const AABB& box)
+{
+    // Expand AABB by sphere radius
+    const float mins[3] = { box.min.x - radius, box.min.y - radius, box.min.z - radius };
+    const float maxs[3] = { box.max.x + radius, box.max.y + radius, box.max.z + radius };
+    const float s[3]  = { start.x, start.y, start.z };
+    const float d[3]  = { end.x - start.x, end.y - start.y, end.z - start.z };
+
+    // Ray vs AABB (slab method)
+    float tmin = 0.0f, tmax = 1.0f;
+    for (int i = 0; i < 3; ++i) {
+        const float mn = mins[i], mx = maxs[i];
+        if (fabsf(d[i]) < 1e-8f) {
+            if (s[i] < mn || s[i] > mx) return false;
+        }
+        else {
+            float ood = 1.0f / d[i];
+            float t1 = (mn - s[i]) * ood;
+            float t2 = (mx - s[i]) * ood;
+            if (t1 > t2) std::swap(t1, t2);
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax) return false;
+        }
+    }
+    return true;
+}
+
+// First contact of a sphere moving from start by delta with a box expanded by
+// the radius (edges and corners count as square, like the player's other
+// tests). The expanded box is open: a sphere resting on a face isn't inside,
+// and sliding along it doesn't hit. Axis is the one whose face is hit; plane is
+// that face's coordinate, where the centre stops.
+struct SweepHit {
+    float t;          // fraction of delta travelled, [0, 1]
+    int   axis;       // 0 = x, 1 = y, 2 = z
+    float plane;
+};
+
+// False when the sweep misses, or starts inside the box (so whatever is already
+// overlapping can always be walked out of)
+inline bool SweptSphereTimeOfImpact(const Vector3& start, const Vector3& delta, float radius,
+                                    const AABB& box, SweepHit& hit) {
+    const float mins[3] = { box.min.x - radius, box.min.y - radius, box.min.z - radius };
+    const float maxs[3] = { box.max.x + radius, box.max.y + radius, box.max.z + radius };
+    const float s[3] = { start.x, start.y, start.z };
+    const float d[3] = { delta.x, delta.y, delta.z };
+
+    float tEnter = -INFINITY, tExit = INFINITY;
+    int   enterAxis = 0;
+    float enterPlane = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        const float mn = mins[i], mx = maxs[i];
+        if (fabsf(d[i]) < 1e-8f) {
+            if (s[i] <= mn || s[i] >= mx) return false;
+            continue;
+        }
+        const float ood = 1.0f / d[i];
+        const float entry = d[i] > 0.0f ? mn : mx;
+        const float leave = d[i] > 0.0f ? mx : mn;
+        const float t1 = (entry - s[i]) * ood;
+        const float t2 = (leave - s[i]) * ood;
+        if (t1 > tEnter) { tEnter = t1; enterAxis = i; enterPlane = entry; }
+        tExit = std::min(tExit, t2);
+    }
+    if (tEnter >= tExit || tEnter < 0.0f || tEnter > 1.0f) return false;
+
+    hit = { tEnter, enterAxis, enterPlane };
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Batched kernels
+// -----------------------------------------------------------------------------
+constexpr int aabbBatchSize = 8;
+
+// Up to aabbBatchSize unexpanded boxes in SoA form, plus a caller-defined id per
+// lane (platform or enemy index) to map hit bits back to objects.
+struct AABBBatch {
+    float    minX[aabbBatchSize], minY[aabbBatchSize], minZ[aabbBatchSize];
+    float    maxX[aabbBatchSize], maxY[aabbBatchSize], maxZ[aabbBatchSize];
+    uint32_t id[aabbBatchSize];
+    int      count;
+};
+
+// The first box of each SIMD group also zeroes the group's other lanes, so the
+// kernel never loads values nobody wrote; its result masks them off anyway
+inline void PushAABB(AABBBatch& batch, const AABB& box, uint32_t id) {
+    const int i = batch.count++;
+    if (i % simd::width == 0) {
+        for (float* lanes : { batch.minX, batch.minY, batch.minZ, batch.maxX, batch.maxY, batch.maxZ })
+            std::fill(lanes + i, lanes + std::min(i + simd::width, aabbBatchSize), 0.0f);
+    }
+    batch.minX[i] = box.min.x; batch.maxX[i] = box.max.x;
+    batch.minY[i] = box.min.y; batch.maxY[i] = box.max.y;
+    batch.minZ[i] = box.min.z; batch.maxZ[i] = box.max.z;
+    batch.id[i]   = id;
+}
+
+inline void PushAABB(AABBBatch& batch, const Vector3& pos, const Vector3& size, uint32_t id) {
+    PushAABB(batch, MakeAABB(pos, size), id);
+}
+
+inline AABB GetBatchAABB(const AABBBatch& batch, int lane) {
+    return { { batch.minX[lane], batch.minY[lane], batch.minZ[lane] },
+             { batch.maxX[lane], batch.maxY[lane], batch.maxZ[lane] } };
+}
+
+inline int LowestSetBit(uint32_t mask) {
+    int lane = 0;
+    while (!(mask & 1u)) { mask >>= 1; ++lane; }
+    return lane;
+}
+
+// One swept sphere against every box in the batch with packed slab math. Bit i of
+// the result is set when lane i is hit; lanes at or past batch.count are never set.
+inline uint32_t SweptSphereVsAABBBatch(const Vector3& start, const Vector3& end, float radius,
+                                       const AABBBatch& batch) {
+    const float s[3] = { start.x, start.y, start.z };
+    const float d[3] = { end.x - start.x, end.y - start.y, end.z - start.z };
+    const float* mins[3] = { batch.minX, batch.minY, batch.minZ };
+    const float* maxs[3] = { batch.maxX, batch.maxY, batch.maxZ };
+    const simd::f32 r = simd::set1(radius);
+
+    uint32_t hits = 0;
+    for (int base = 0; base < batch.count; base += simd::width) {
+        simd::f32 tmin = simd::set1(0.0f);
+        simd::f32 tmax = simd::set1(1.0f);
+        simd::f32 inside = simd::cmple(tmin, tmax);   // all lanes set
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const simd::f32 mn = simd::sub(simd::load(mins[axis] + base), r);
+            const simd::f32 mx = simd::add(simd::load(maxs[axis] + base), r);
+            const simd::f32 sv = simd::set1(s[axis]);
+
+            // The direction is shared by all lanes, so the parallel case is a scalar branch
+            if (fabsf(d[axis]) < 1e-8f) {
+                inside = simd::bitand_(inside, simd::bitand_(simd::cmple(mn, sv), simd::cmple(sv, mx)));
+                continue;
+            }
+            const simd::f32 ood = simd::set1(1.0f / d[axis]);
+            const simd::f32 t1  = simd::mul(simd::sub(mn, sv), ood);
+            const simd::f32 t2  = simd::mul(simd::sub(mx, sv), ood);
+            tmin = simd::max(tmin, simd::min(t1, t2));
+            tmax = simd::min(tmax, simd::max(t1, t2));
+        }
+
+        inside = simd::bitand_(inside, simd::cmple(tmin, tmax));
+        hits |= simd::movemask(inside) << base;
+    }
+
+    const uint32_t valid = (batch.count >= 32) ? ~0u : ((1u << batch.count) - 1u);
+    return hits & valid;
+}
+
+// Up to aabbBatchSize rays in SoA form, traced together. Directions are unit
+// length so t is a distance; tMax[i] is the nearest hit so far (initially the
+// ray's range), and lanes at or past count never report a hit.
+struct RayPacket {
+    float ox[aabbBatchSize], oy[aabbBatchSize], oz[aabbBatchSize];
+    float invDx[aabbBatchSize], invDy[aabbBatchSize], invDz[aabbBatchSize];
+    float tMax[aabbBatchSize];
+    int   count;
+};
+
+inline void PushRay(RayPacket& packet, const Vector3& origin, const Vector3& dir, float range) {
+    // Near-zero components get a huge but finite reciprocal so the slab products stay defined
+    auto safeInv = [](float d) { return 1.0f / (fabsf(d) < 1e-8f ? (d < 0.0f ? -1e-8f : 1e-8f) : d); };
+    const int i = packet.count++;
+    packet.ox[i] = origin.x; packet.oy[i] = origin.y; packet.oz[i] = origin.z;
+    packet.invDx[i] = safeInv(dir.x); packet.invDy[i] = safeInv(dir.y); packet.invDz[i] = safeInv(dir.z);
+    packet.tMax[i] = range;
+}
+
+// One box against every ray in the packet with packed slab math. Bit i of the
+// result is set when ray i enters the box before its tMax; tEnter[i] is then the
+// entry distance (0 when the ray starts inside).
+inline uint32_t RayPacketVsAABB(const RayPacket& packet, const Vector3& boxMin, const Vector3& boxMax,
+                                float* tEnter) {
+    const float* origins[3] = { packet.ox, packet.oy, packet.oz };
+    const float* invDirs[3] = { packet.invDx, packet.invDy, packet.invDz };
+    const float mins[3] = { boxMin.x, boxMin.y, boxMin.z };
+    const float maxs[3] = { boxMax.x, boxMax.y, boxMax.z };
+
+    uint32_t hits = 0;
+    for (int base = 0; base < packet.count; base += simd::width) {
+        simd::f32 tmin = simd::set1(0.0f);
+        simd::f32 tmax = simd::load(packet.tMax + base);
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const simd::f32 o   = simd::load(origins[axis] + base);
+            const simd::f32 inv = simd::load(invDirs[axis] + base);
+            const simd::f32 t1  = simd::mul(simd::sub(simd::set1(mins[axis]), o), inv);
+            const simd::f32 t2  = simd::mul(simd::sub(simd::set1(maxs[axis]), o), inv);
+            tmin = simd::max(tmin, simd::min(t1, t2));
+            tmax = simd::min(tmax, simd::max(t1, t2));
+        }
+
+        simd::store(tEnter + base, tmin);
+        hits |= simd::movemask(simd::cmple(tmin, tmax)) << base;
+    }
+
+    const uint32_t valid = (packet.count >= 32) ? ~0u : ((1u << packet.count) - 1u);
+    return hits & valid;
+}
+
+// -----------------------------------------------------------------------------
+// Platform queries
+// -----------------------------------------------------------------------------
+// Grid broadphase plus narrowphase against the level's platform boxes, with the
+// shape and the filter as template parameters: each call site gets its own
+// loop, with the filter test and any constant radius folded into it.
+
+// Filter policies: which platform indices a query considers
+struct AllPlatforms {
+    static constexpr bool Accept(uint32_t) { return true; }
+};
+
+// Platform 0 is the floor, which everything on the ground is touching
+struct SkipFloor {
+    static constexpr bool Accept(uint32_t index) { return index != 0; }
+};
+
+// Sphere whose radius is known at compile time, given by a tag type:
+//   struct EnemyRadius { static constexpr float value = 0.5f; };
+template <typename Radius>
+struct FixedSphere {
+    static constexpr float radius = Radius::value;
+    Vector3 centre;
+};
+
+struct SweptSphere {
+    Vector3 start;
+    Vector3 delta;
+    float   radius;
+};
+
+template <typename Radius>
+inline XZBounds QueryFootprint(const FixedSphere<Radius>& s) {
+    return { s.centre.x - s.radius, s.centre.z - s.radius, s.centre.x + s.radius, s.centre.z + s.radius };
+}
+
+inline XZBounds QueryFootprint(const SweptSphere& s) {
+    const float endX = s.start.x + s.delta.x, endZ = s.start.z + s.delta.z;
+    return { std::min(s.start.x, endX) - s.radius, std::min(s.start.z, endZ) - s.radius,
+             std::max(s.start.x, endX) + s.radius, std::max(s.start.z, endZ) + s.radius };
+}
+
+template <typename Radius>
+inline bool Overlaps(const FixedSphere<Radius>& s, const AABB& box) {
+    return SphereVsAABB(s.centre, s.radius, box);
+}
+
+inline bool Overlaps(const SweptSphere& s, const AABB& box) {
+    const Vector3 end = { s.start.x + s.delta.x, s.start.y + s.delta.y, s.start.z + s.delta.z };
+    return SweptSphereVsAABB(s.start, end, s.radius, box);
+}
+
+// Calls fn(platformIndex) for each platform the filter accepts and the shape
+// touches; fn returns true to stop. Returns the broadphase candidates visited.
+template <typename Filter, typename Shape, typename Fn>
+inline uint32_t QueryPlatforms(const PlatformGrid& grid, const AABB* bounds, const Shape& shape, Fn&& fn) {
+    const XZBounds area = QueryFootprint(shape);
+    return QueryPlatformGrid(grid, area.minX, area.minZ, area.maxX, area.maxZ,
+        [&](uint32_t i) {
+            return Filter::Accept(i) && Overlaps(shape, bounds[i]) && fn(i);
+        });
+}
+
+template <typename Filter, typename Shape>
+inline bool AnyPlatformOverlaps(const PlatformGrid& grid, const AABB* bounds, const Shape& shape,
+                                SpatialQueryStats& stats) {
+    bool hit = false;
+    const uint32_t tested = QueryPlatforms<Filter>(grid, bounds, shape, [&](uint32_t) {
+        hit = true;
+        return true;
+    });
+    AddQueryStats(stats, tested);
+    return hit;
+}
+
+// Earliest contact of the sweep with the listed platforms, for a candidate set
+// gathered once and swept several times. False when nothing is hit.
+template <typename Filter>
+inline bool FirstPlatformHit(const AABB* bounds, const uint32_t* indices, size_t count,
+                             const SweptSphere& sweep, SweepHit& first) {
+    first = { 2.0f, 0, 0.0f };
+    for (size_t k = 0; k < count; ++k) {
+        const uint32_t i = indices[k];
+        SweepHit hit;
+        if (Filter::Accept(i) &&
+            SweptSphereTimeOfImpact(sweep.start, sweep.delta, sweep.radius, bounds[i], hit) && hit.t < first.t)
+            first = hit;
+    }
+    return first.t <= 1.0f;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Generational reference to a pooled entity. A handle outlives the entity it
+// names: once the slot is freed its generation moves on and the handle stops
+// resolving, even after the slot is reused.
+struct EntityHandle {
+    uint32_t slot;
+    uint32_t generation;    // 0 never names a live entity
+
+    bool operator==(const EntityHandle& o) const { return slot == o.slot && generation == o.generation; }
+    bool operator!=(const EntityHandle& o) const { return !(*this == o); }
+};
+
+constexpr EntityHandle nullEntity = { 0, 0 };
+
+// Slot bookkeeping shared by the pools. Live entities stay densely packed in
+// [0, count) for iteration; each stable slot maps to its current dense index and
+// removal swaps the last entity into the hole, so iteration, spawn and removal
+// are O(1). All tables are sized once, so nothing reallocates after Init.
+struct HandleTable {
+    std::vector<uint32_t> generation;    // per slot
+    std::vector<uint32_t> slotToDense;
+    std::vector<uint32_t> denseToSlot;
+    std::vector<uint32_t> freeSlots;     // stack
+    uint32_t count;
+    uint32_t capacity;
+};
+
+void InitHandleTable(HandleTable& table, uint32_t capacity);
+void ClearHandleTable(HandleTable& table);
+
+// Rebuilds the table so live[i] is the entity at dense index i (save states).
+// Other handles into the table go stale. Returns false, leaving the table
+// cleared, on an out-of-range slot, a null generation or a repeated slot.
+bool RestoreHandleTable(HandleTable& table, const EntityHandle* live, uint32_t count);
+
+// Takes a free slot and appends it to the dense range; the caller writes the
+// entity at dense index count - 1. Returns nullEntity when full.
+EntityHandle AcquireHandle(HandleTable& table);
+
+// Frees the entity at dense index i. The caller must move its last dense
+// element (count before the call - 1) into i, as the table just did.
+void ReleaseDense(HandleTable& table, uint32_t i);
+
+inline bool ResolveHandle(const HandleTable& table, EntityHandle h, uint32_t& dense) {
+    if (h.generation == 0 || h.slot >= table.capacity || table.generation[h.slot] != h.generation)
+        return false;
+    dense = table.slotToDense[h.slot];
+    return true;
+}
+
+inline EntityHandle HandleAtDense(const HandleTable& table, uint32_t dense) {
+    const uint32_t slot = table.denseToSlot[dense];
+    return { slot, table.generation[slot] };
+}
+
+// -----------------------------------------------------------------------------
+// Array-of-structs pool; iterates like a vector over the live entities
+// -----------------------------------------------------------------------------
+template <typename T>
+struct EntityPool {
+    HandleTable    handles;
+    std::vector<T> items;    // capacity entries, [0, size()) live
+
+    T*       begin()             { return items.data(); }
+    T*       end()               { return items.data() + handles.count; }
+    const T* begin() const       { return items.data(); }
+    const T* end() const         { return items.data() + handles.count; }
+    T*       data()              { return items.data(); }
+    const T* data() const        { return items.data(); }
+    size_t   size() const        { return handles.count; }
+    size_t   capacity() const    { return handles.capacity; }
+    bool     empty() const       { return handles.count == 0; }
+    T&       operator[](size_t i)       { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+};
+
+template <typename T>
+void InitEntityPool(EntityPool<T>& pool, uint32_t capacity) {
+    InitHandleTable(pool.handles, capacity);
+    pool.items.assign(capacity, T{});
+}
+
+template <typename T>
+void ClearEntities(EntityPool<T>& pool) {
+    ClearHandleTable(pool.handles);
+}
+
+template <typename T>
+EntityHandle SpawnEntity(EntityPool<T>& pool, const T& value) {
+    const EntityHandle h = AcquireHandle(pool.handles);
+    if (h.generation != 0) pool.items[pool.handles.count - 1] = value;
+    return h;
+}
+
+template <typename T>
+void RemoveEntityAt(EntityPool<T>& pool, size_t i) {
+    const size_t last = pool.handles.count - 1;
+    if (i != last) pool.items[i] = pool.items[last];
+    ReleaseDense(pool.handles, (uint32_t)i);
+}
+
+template <typename T>
+bool RemoveEntity(EntityPool<T>& pool, EntityHandle h) {
+    uint32_t dense;
+    if (!ResolveHandle(pool.handles, h, dense)) return false;
+    RemoveEntityAt(pool, dense);
+    return true;
+}
+
+template <typename T>
+T* GetEntity(EntityPool<T>& pool, EntityHandle h) {
+    uint32_t dense;
+    return ResolveHandle(pool.handles, h, dense) ? &pool.items[dense] : nullptr;
+}
+
+template <typename T>
+EntityHandle EntityHandleAt(const EntityPool<T>& pool, size_t i) {
+    return HandleAtDense(pool.handles, (uint32_t)i);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "raylib.h"
+#include "arena.h"
+#include "entitypool.h"
+#include <cstdint>
+#include <vector>
+
+// Gameplay side effects raised during a tick. Producers only push events, so
+// loops that detect hits or contact can run in parallel, and everything that
+// reacts to them (damage, scoring, and later sounds or particles) runs in one
+// pass at the end of the tick, a tight loop per event type.
+//
+// Enemy indices are dense pool indices, valid until RemoveDeadEntities() at
+// the end of the tick; events never outlive the tick that raised them.
+
+struct ShotFiredEvent {
+    Vector3 origin;
+    Vector3 dir;
+    bool    hitscan;
+};
+
+struct HitEvent {
+    uint32_t enemy;
+    int      damage;
+    Vector3  point;
+};
+
+// A round or ray stopped by level geometry
+struct ImpactEvent {
+    Vector3 point;
+};
+
+// Raised by the hit pass for an enemy whose health just reached zero
+struct KillEvent {
+    EntityHandle enemy;
+    Vector3      position;
+};
+
+struct PlayerDamagedEvent {
+    uint32_t enemy;     // the one that made contact
+    int      damage;
+};
+
+// One lane per job thread. A producer pushes only into the lane of the thread
+// it runs on, so there is no locking, and lanes sit on their own cache lines.
+template <typename T>
+struct alignas(64) EventLane {
+    std::vector<T> events;   // cleared, not freed, between ticks
+};
+
+template <typename T>
+struct EventQueue {
+    std::vector<EventLane<T>> lanes;
+};
+
+template <typename T>
+inline void PrepareEventQueue(EventQueue<T>& queue, int laneCount) {
+    if (queue.lanes.size() == (size_t)laneCount) return;
+    AllocGuardMarkUnsteady();
+    queue.lanes.clear();
+    queue.lanes.resize((size_t)laneCount);
+}
+
+// Lanes keep their capacity, so only a new high-water mark allocates
+template <typename T>
+inline void PushEvent(EventQueue<T>& queue, int lane, const T& event) {
+    std::vector<T>& events = queue.lanes[(size_t)lane].events;
+    if (events.size() == events.capacity()) AllocGuardMarkUnsteady();
+    events.push_back(event);
+}
+
+// Lanes in order, so consumers see a deterministic order for any one producer
+template <typename T, typename Fn>
+inline void ConsumeEvents(EventQueue<T>& queue, Fn&& fn) {
+    for (EventLane<T>& lane : queue.lanes) {
+        for (const T& event : lane.events)
+            fn(event);
+        lane.events.clear();
+    }
+}
+
+struct TickEvents {
+    EventQueue<ShotFiredEvent>     shots;
+    EventQueue<HitEvent>           hits;
+    EventQueue<ImpactEvent>        impacts;
+    EventQueue<KillEvent>          kills;
+    EventQueue<PlayerDamagedEvent> playerDamage;
+};
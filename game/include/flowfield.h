@@ -0,0 +1,71 @@
+#pragma once
+#include "spatial.h"
+#include <cstdint>
+#include <vector>
+#include <cmath>
+
+struct Platform;
+
+// Grid flow field over the floor pointing every walkable cell one step closer to
+// a goal (the player). Obstacles are baked once per platform layout; the distance
+// and direction fields are rebuilt only when the goal changes cell, so the cost
+// is O(cells) per rebuild and each enemy steers with one lookup.
+struct FlowField {
+    float originX;
+    float originZ;
+    float cellSize;
+    float invCellSize;
+    int   cellsX;
+    int   cellsZ;
+    std::vector<uint8_t>  blocked;     // 1 = an obstacle covers the cell centre
+    std::vector<uint32_t> cost;        // path cost to the goal, flowUnreachable if none
+    std::vector<int8_t>   dirX;        // step to the next cell toward the goal,
+    std::vector<int8_t>   dirZ;        // (0, 0) at the goal or when unreachable
+    std::vector<uint64_t> open;        // Dijkstra heap scratch, cost << 32 | cell
+    int      goalX;
+    int      goalZ;
+    uint64_t rebuilds;                 // for the debug overlay
+};
+
+constexpr float    flowFieldCellSize = 1.0f;
+constexpr float    flowFieldMaxRange = 64.0f;   // search stops this far (path length) from the goal
+constexpr uint32_t flowUnreachable   = UINT32_MAX;
+
+// Covers `area` (the walkable floor) and marks cells whose centre lies within
+// `clearance` of any platform after the first (the floor) overlapping the
+// [bandMinY, bandMaxY] slab an enemy occupies. Resets the goal so the next
+// UpdateFlowField() rebuilds.
+void BuildFlowFieldObstacles(FlowField& field, const Platform* platforms, size_t count,
+                             const XZBounds& area, float clearance, float bandMinY, float bandMaxY,
+                             float cellSize = flowFieldCellSize);
+
+// Rebuilds the distance and direction fields if goal lies in a different cell
+// from the last build. Returns true when it rebuilt. Cells further than
+// flowFieldMaxRange along the path stay unreachable, which keeps a rebuild
+// bounded on large (streamed) floors.
+bool UpdateFlowField(FlowField& field, float goalX, float goalZ);
+
+// Unit XZ direction to steer along from (x, z). Returns false at the goal cell,
+// on blocked or unreachable cells, or before the field is built; callers then
+// seek the goal directly. Read-only, safe from several threads.
+inline bool SampleFlowField(const FlowField& field, float x, float z, float& outX, float& outZ) {
+    if (field.cellsX == 0 || field.cost.empty()) return false;
+    const int cx = GridCellCoord(x, field.originX, field.invCellSize, field.cellsX);
+    const int cz = GridCellCoord(z, field.originZ, field.invCellSize, field.cellsZ);
+    const size_t c = (size_t)cz * field.cellsX + cx;
+    const int dx = field.dirX[c];
+    const int dz = field.dirZ[c];
+    if (dx == 0 && dz == 0) return false;
+
+    // Aim at the next cell's centre rather than along the raw grid step, so an
+    // enemy off-centre in a corridor is pulled back into it
+    const float tx = field.originX + (cx + dx + 0.5f) * field.cellSize;
+    const float tz = field.originZ + (cz + dz + 0.5f) * field.cellSize;
+    const float vx = tx - x;
+    const float vz = tz - z;
+    const float len = sqrtf(vx*vx + vz*vz);
+    if (len < 1e-4f) return false;
+    outX = vx / len;
+    outZ = vz / len;
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include <cmath>
+#include <algorithm>
+
+// Six inward-facing planes: dot(normal, p) + d >= 0 for points inside
+struct FrustumPlane {
+    Vector3 normal;
+    float   d;
+};
+
+struct Frustum {
+    FrustumPlane planes[6];   // left, right, bottom, top, near, far
+    Vector3 corners[8];       // near quad then far quad, for broadphase bounds
+};
+
+inline FrustumPlane MakePlane(const Vector3& normal, const Vector3& point) {
+    const Vector3 n = Vector3Normalize(normal);
+    return { n, -Vector3DotProduct(n, point) };
+}
+
+// Built from the camera basis rather than the projection matrix; fovy is vertical
+// in degrees, as in raylib's Camera3D.
+inline Frustum MakeFrustum(const Camera3D& camera, float aspect, float nearPlane, float farPlane) {
+    const Vector3 f = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    const Vector3 r = Vector3Normalize(Vector3CrossProduct(f, camera.up));
+    const Vector3 u = Vector3CrossProduct(r, f);
+    const float halfV = tanf(camera.fovy * DEG2RAD * 0.5f);
+    const float halfH = halfV * aspect;
+    const Vector3& eye = camera.position;
+
+    const Vector3 dl = Vector3Subtract(f, Vector3Scale(r, halfH));
+    const Vector3 dr = Vector3Add(f, Vector3Scale(r, halfH));
+    const Vector3 db = Vector3Subtract(f, Vector3Scale(u, halfV));
+    const Vector3 dt = Vector3Add(f, Vector3Scale(u, halfV));
+
+    Frustum fr;
+    fr.planes[0] = MakePlane(Vector3CrossProduct(dl, u), eye);
+    fr.planes[1] = MakePlane(Vector3CrossProduct(u, dr), eye);
+    fr.planes[2] = MakePlane(Vector3CrossProduct(r, db), eye);
+    fr.planes[3] = MakePlane(Vector3CrossProduct(dt, r), eye);
+    fr.planes[4] = MakePlane(f, Vector3Add(eye, Vector3Scale(f, nearPlane)));
+    fr.planes[5] = MakePlane(Vector3Negate(f), Vector3Add(eye, Vector3Scale(f, farPlane)));
+
+    int c = 0;
+    for (float dist : { nearPlane, farPlane }) {
+        const Vector3 centre = Vector3Add(eye, Vector3Scale(f, dist));
+        const Vector3 ox = Vector3Scale(r, halfH * dist);
+        const Vector3 oy = Vector3Scale(u, halfV * dist);
+        for (float sy : { -1.0f, 1.0f })
+            for (float sx : { -1.0f, 1.0f })
+                fr.corners[c++] = Vector3Add(centre, Vector3Add(Vector3Scale(ox, sx), Vector3Scale(oy, sy)));
+    }
+    return fr;
+}
+
+inline bool AABBInFrustum(const Frustum& fr, const Vector3& min, const Vector3& max) {
+    for (const FrustumPlane& p : fr.planes) {
+        // Corner furthest along the plane normal
+        const Vector3 v = {
+            p.normal.x >= 0.0f ? max.x : min.x,
+            p.normal.y >= 0.0f ? max.y : min.y,
+            p.normal.z >= 0.0f ? max.z : min.z
+        };
+        if (Vector3DotProduct(p.normal, v) + p.d < 0.0f) return false;
+    }
+    return true;
+}
+
+inline bool SphereInFrustum(const Frustum& fr, const Vector3& centre, float radius) {
+    for (const FrustumPlane& p : fr.planes) {
+        if (Vector3DotProduct(p.normal, centre) + p.d < -radius) return false;
+    }
+    return true;
+}
+
+// XZ rectangle covering the frustum, for spatial index queries
+inline void FrustumBoundsXZ(const Frustum& fr, float& minX, float& minZ, float& maxX, float& maxZ) {
+    minX = maxX = fr.corners[0].x;
+    minZ = maxZ = fr.corners[0].z;
+    for (const Vector3& c : fr.corners) {
+        minX = std::min(minX, c.x); maxX = std::max(maxX, c.x);
+        minZ = std::min(minZ, c.z); maxZ = std::max(maxZ, c.z);
+    }
+}
@@ -1,10 +1,20 @@
 #pragma once
 #include "raylib.h"
 #include "raymath.h"
+#include "spatial.h"
+#include "collision.h"
+#include "projectiles.h"
+#include "flowfield.h"
+#include "level.h"
+#include "streaming.h"
+#include "entitypool.h"
+#include "events.h"
+#include "waves.h"
 #include <vector>
 
 struct Player {
     Vector3 position;
+    Vector3 prevPosition; // position at the start of the last tick (render interpolation)
     float speed;
     float walkSpeed;
     float runSpeed;
@@ -31,41 +41,162 @@ struct Player {
     float survivalTime;
 };
 
-struct Platform {
-    Vector3 position;
-    Vector3 size;
-    Color colour;
-};
-
-struct Projectile {
-    Vector3 position;
-    Vector3 velocity;
-    float radius;
-    float lifetime;
-};
-
 struct Enemy {
     Vector3 position;
+    Vector3 prevPosition;
     Vector3 size;
     int health;
     float flashTimer;
     float damageCooldown;
 };
 
+// Per-thread results of one enemy update, reduced into player/world state at the
+// end of the tick. Padded to a cache line so neighbouring threads don't share one.
+struct alignas(64) EnemyTickAccumulator {
+    SpatialQueryStats platformStats;
+    SpatialQueryStats enemyStats;
+};
+
+// Fire modes: simulated rounds, or rays resolved on the tick they are fired
+enum WeaponMode {
+    WEAPON_PROJECTILE = 0,
+    WEAPON_HITSCAN
+};
+
+constexpr int hitscanMaxShots = 8;    // per tick; one ray packet
+constexpr int tracerCapacity  = 32;
+constexpr float tracerLifetime = 0.08f;
+
+struct HitscanShot {
+    Vector3 origin;
+    Vector3 dir;                      // unit length
+};
+
+// Line left behind by a hitscan shot, fading over its lifetime
+struct Tracer {
+    Vector3 start;
+    Vector3 end;
+    float   timeLeft;
+};
+
+struct HitscanState {
+    HitscanShot shots[hitscanMaxShots];   // queued this tick, resolved together
+    int shotCount;
+    std::vector<uint32_t> platformMark;   // stamp of the last packet that tested each
+    std::vector<uint32_t> enemyMark;      // platform / enemy slot, to test each once
+    uint32_t stamp;
+    Tracer tracers[tracerCapacity];       // ring; timeLeft <= 0 is free
+    int tracerHead;
+};
+
 struct World {
     Camera3D camera;
-    std::vector<Platform> platforms;
-    std::vector<Projectile> projectiles;
-    std::vector<Enemy> enemies;
-    float enemySpawnTimer;
+    PlatformList platforms;               // view into level; platforms[0] is the floor
+    ProjectilePool projectiles;
+    EntityPool<Enemy> enemies;            // sized to the enemy limit at reset
+    EntityHandle lastHitEnemy;            // most recent enemy a round struck; may have died since
+    WaveDirector waves;
+    uint32_t platformsVersion;            // bumped whenever the platform set changes
+    PlatformGrid platformGrid;            // built or mapped with the level
+    std::vector<AABB> platformBounds;     // box of each platform, built with the level
+    SpatialQueryStats platformQueryStats;
+    EnemyGrid enemyGrid;                  // rebuilt whenever enemies move or are removed
+    SpatialQueryStats enemyQueryStats;
+    FlowField flowField;                  // enemy navigation toward the player
+    Level level;                          // storage behind platforms and platformGrid
+    XZBounds activeBounds;                // floor area in play: all of it, or the resident chunks
+    HitscanState hitscan;
+    TickEvents events;                    // raised this tick, applied at its end
+};
+
+// One match: the world, its player and the rules state the tick reads. The
+// windowed game runs a single arena; the headless runner can tick many side by
+// side (--arenas), each on one thread at a time.
+struct GameArena {
+    World      world;
+    Player     player;
+    WeaponMode weaponMode;
+    bool       isGameOver;
+    int        enemyLimit;
+    uint32_t   seed;
+    Xoshiro128 rng;           // spawn positions come from here
 };
 
-// Expose world and player
-extern World world;
-extern Player player;
+// The arena the calling thread simulates: the one it bound, else the process's
+// main arena. Every Game* call below acts on it. Jobs inside a tick don't bind
+// one, so a thread ticking a bound arena needs the job system running inline
+// (JobsInit(1)).
+GameArena& CurrentArena();
+inline World&  CurrentWorld()  { return CurrentArena().world; }
+inline Player& CurrentPlayer() { return CurrentArena().player; }
+void GameBindArena(GameArena* arena);   // nullptr goes back to the main arena
+
+// Extra arenas start like the main one does at launch, with their own seed
+GameArena* GameCreateArena(uint32_t seed);
+void GameDestroyArena(GameArena* arena);
+
+// Input consumed by one simulation tick. Edge-triggered presses and mouse motion
+// are latched across render frames until a tick consumes them.
+struct TickInput {
+    Vector2 mouseDelta;
+    bool moveForward;
+    bool moveBack;
+    bool moveLeft;
+    bool moveRight;
+    bool running;
+    bool crouching;
+    bool jumpPressed;
+    bool firePressed;
+    bool switchWeaponPressed;
+};
 
 // Game lifecycle functions
-void GameInit();
+void GameInit();     // opens the window on first call, then GameReset()
+void GameReset();    // simulation state only; safe without a window
 void GameCleanup();
-bool GameUpdate();
-void GameDraw();
+bool GameUpdate();   // per render frame: hands input to the simulation thread (started on first call)
+void GameDraw();     // draws the newest published snapshot
+
+// Fixed-timestep simulation
+void GameSetTickRate(int hz);
+void GameTick(float dt, const TickInput& input);
+bool GameIsOver();
+
+// Two of GameTick's phases on their own, for the microbenchmarks. Scratch
+// comes from the frame arena and side effects go into the tick's event queues,
+// which the first GameTick sets up.
+void UpdatePlayer(float dt, const TickInput& input);
+void UpdateEnemies(float dt);
+
+// Levels. Loading replaces the platform set and resets the simulation; in the
+// windowed game, only before the first GameUpdate().
+bool GameLoadLevel(const char* path);                 // .lvl text, compiled .lxl or streamed .lxs
+void GameSetPlatforms(std::vector<Platform> platforms);
+void GameLoadDefaultLevel();
+
+// Simulation setup, used by the headless runner
+void GameSeedRandom(uint32_t seed);   // spawn positions come from this stream
+uint32_t GameGetSeed();
+constexpr int enemyLimitMax = 1 << 16;
+void GameSetEnemyLimit(int limit);    // default enemyMaxCount, clamped to [0, enemyLimitMax]
+void GameSetWeaponMode(WeaponMode mode);
+WeaponMode GameGetWeaponMode();
+int  GameGetTickRate();
+int  GameGetEnemyLimit();
+
+// Hash of the simulation state that input and the seed determine: player,
+// enemies, rounds, timers. Replays compare it to detect divergence.
+uint64_t GameStateChecksum();
+
+// Save states (savestate.h): the whole simulation state between two ticks.
+// Restoring refuses states taken on another level. The windowed game
+// quick-saves with F5 and loads with F9.
+struct SaveState;
+void GameCaptureState(SaveState& state, uint64_t tick);
+bool GameRestoreState(const SaveState& state);
+
+// Windowed game: records every tick from a fresh reset until GameCleanup().
+// Call after any GameLoadLevel(), before the first GameUpdate(); streamed levels
+// should be opened with StreamSetSynchronous(true) so playback matches.
+bool GameRecordReplay(const char* path);
+int  SpawnEnemies(int count);         // up to the free room in the pool; returns how many
@@ -0,0 +1,40 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Everything the HUD shows, at the precision it is shown with: two states that
+// compare equal rasterize to the same pixels.
+struct HudState {
+    int  screenWidth;
+    int  screenHeight;
+    bool gameOver;
+    int  health;
+    int  score;
+    int  enemiesDefeated;
+    int  accuracyTenths;     // accuracy in 0.1 % steps
+    int  survivalTenths;     // survival time in 0.1 s steps
+    bool hitscan;
+};
+
+constexpr double hudFpsInterval = 0.5;   // seconds between FPS counter updates
+
+// Screen-sized layer holding the rasterized HUD (crosshair, counters, or the
+// game-over screen). It is redrawn only when the HudState or the sampled FPS
+// changes; every other frame costs one textured quad.
+struct Hud {
+    RenderTexture2D target;
+    HudState shown;
+    int      fps;            // sampled every hudFpsInterval
+    double   fpsSampledAt;
+    bool     valid;          // target holds shown
+    uint64_t redraws;
+};
+
+extern Hud hud;
+
+void InitHud();
+void ShutdownHud();
+
+// Draws the cached layer over the frame, rasterizing it first if out of date.
+// Call between BeginDrawing()/EndDrawing(), outside any 3D or texture mode.
+void DrawHud(const HudState& state);
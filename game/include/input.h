@@ -0,0 +1,42 @@
+#pragma once
+#include "game.h"
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Live input (windowed build)
+// -----------------------------------------------------------------------------
+
+// Folds this frame's raylib input into pending: held keys are overwritten,
+// presses and mouse motion accumulate until ConsumeTickInput()
+void LatchLiveInput(TickInput& pending);
+
+// Clears the edge-triggered parts of pending once a tick has used them
+void ConsumeTickInput(TickInput& pending);
+
+// -----------------------------------------------------------------------------
+// Scripted input (headless build)
+// -----------------------------------------------------------------------------
+
+// One script line: hold `input` for `ticks` ticks. Presses repeat every tick.
+struct InputScriptStep {
+    int ticks;
+    TickInput input;
+};
+
+struct InputScript {
+    std::vector<InputScriptStep> steps;
+    size_t step;
+    int    tickInStep;
+    bool   loop;           // restart from the first step when the script runs out
+};
+
+// Text format, one step per line, '#' starts a comment:
+//   <ticks> <flags> <mouseDx> <mouseDy>
+// flags is any of W A S D (move) R (run) C (crouch) J (jump) F (fire)
+// Q (switch weapon), or '-'
+bool LoadInputScript(InputScript& script, const char* path);
+
+// Built-in benchmark script: circle-strafe while sweeping the view and firing
+void MakeDefaultInputScript(InputScript& script);
+
+TickInput NextScriptedInput(InputScript& script);
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+// Small work-stealing job system. Each thread owns a double-ended queue: it pops its own work
+// from the back and steals from the front of the others. Thread 0 is the thread
+// that called JobsInit() and takes part in every ParallelFor. Jobs must not call
+// ParallelFor themselves.
+
+// threadCount includes the caller: 0 = one per hardware thread, 1 = run inline
+void JobsInit(int threadCount = 0);
+void JobsShutdown();
+
+// Threads that may run a job (workers + the calling thread), for sizing
+// per-thread accumulators
+int JobsThreadCount();
+
+using JobFn = void (*)(void* ctx, size_t begin, size_t end, int threadIndex);
+
+// Runs fn over [0, count) in chunks of `grain` and returns when every chunk has
+// finished. threadIndex is in [0, JobsThreadCount()).
+void ParallelFor(size_t count, size_t grain, JobFn fn, void* ctx);
+
+template <typename Fn>
+inline void ParallelFor(size_t count, size_t grain, Fn&& fn) {
+    auto trampoline = [](void* ctx, size_t begin, size_t end, int threadIndex) {
+        (*static_cast<Fn*>(ctx))(begin, end, threadIndex);
+    };
+    ParallelFor(count, grain, +trampoline, &fn);
+}
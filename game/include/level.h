@@ -0,0 +1,95 @@
+#pragma once
+#include "raylib.h"
+#include "spatial.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Platform {
+    Vector3 position;
+    Vector3 size;
+    Color colour;
+};
+
+// Read-only view of the current level's platforms. The records live either in
+// Level::ownedPlatforms or directly in a mapped compiled level file.
+struct PlatformList {
+    const Platform* items = nullptr;
+    size_t          count = 0;
+
+    const Platform* begin() const { return items; }
+    const Platform* end() const   { return items + count; }
+    const Platform* data() const  { return items; }
+    size_t size() const           { return count; }
+    bool empty() const            { return count == 0; }
+    const Platform& operator[](size_t i) const { return items[i]; }
+};
+
+// Whole-file read-only memory mapping
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t         size = 0;
+    void*          handle = nullptr;    // platform mapping handle, if any
+};
+
+bool MapFile(const char* path, MappedFile& file);
+void UnmapFile(MappedFile& file);
+
+// Storage behind the world's PlatformList and PlatformGrid
+struct Level {
+    std::vector<Platform> ownedPlatforms;   // text, built-in or generated levels
+    MappedFile            file;             // compiled levels, used in place
+};
+
+// -----------------------------------------------------------------------------
+// Text format (.lvl), one record per line, '#' starts a comment:
+//
+//     platform  <px> <py> <pz>  <sx> <sy> <sz>  <r> <g> <b> [a]
+//
+// Position is the box centre, colour channels are 0-255. The first platform is
+// the floor that players and enemies spawn on.
+// -----------------------------------------------------------------------------
+bool ParseLevelText(const char* path, std::vector<Platform>& platforms);
+
+// -----------------------------------------------------------------------------
+// Compiled format (.lxl): a header followed by 16-byte aligned sections holding
+// the Platform records and the PlatformGrid arrays exactly as they sit in
+// memory, so a mapped file is used in place with no parsing or allocation.
+// Native byte order; files from a build with a different Platform layout are
+// rejected by the stride check.
+// -----------------------------------------------------------------------------
+constexpr char     levelFileMagic[4] = { 'L', 'X', 'L', 'V' };
+constexpr uint32_t levelFileVersion  = 1;
+
+struct LevelFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t platformCount;
+    uint32_t platformStride;       // sizeof(Platform) at compile time
+    float    gridOriginX;
+    float    gridOriginZ;
+    float    gridCellSize;
+    int32_t  gridCellsX;
+    int32_t  gridCellsZ;
+    uint32_t gridCellItemCount;
+    uint32_t gridLargeItemCount;
+    uint32_t reserved;
+    uint64_t platformsOffset;
+    uint64_t cellStartOffset;      // gridCellsX * gridCellsZ + 1 entries
+    uint64_t cellItemsOffset;
+    uint64_t itemCellMinXOffset;   // platformCount entries each
+    uint64_t itemCellMinZOffset;
+    uint64_t largeItemsOffset;
+    uint64_t fileSize;
+};
+
+bool IsCompiledLevel(const char* path);
+
+// Builds the grid for platforms and writes both to path
+bool WriteCompiledLevel(const char* path, const Platform* platforms, size_t count);
+
+// Maps path into level.file and points platforms and grid straight at it. On
+// failure the outputs are left untouched.
+bool MapCompiledLevel(const char* path, Level& level, PlatformList& platforms, PlatformGrid& grid);
+
+void ReleaseLevel(Level& level);
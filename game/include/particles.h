@@ -0,0 +1,46 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+
+// GPU particles for impacts and deaths. Gameplay only queues emits; each emit
+// becomes one record in a ring buffer that lives on the GPU, and every particle
+// of every burst is worked out in the vertex shader from its record, its index
+// and the time since it was emitted (ballistic flight, fade, shrink). Nothing
+// is stepped per particle on the CPU: a frame uploads only the emits queued
+// since the last one and issues one instanced draw.
+
+enum ParticleKind : uint8_t {
+    PARTICLE_SPARK = 0,   // a round striking a surface or an enemy
+    PARTICLE_BURST,       // an enemy dying
+    PARTICLE_KIND_COUNT
+};
+
+struct ParticleEmit {
+    Vector3      position;
+    ParticleKind kind;
+};
+
+constexpr int   particleEmitCapacity = 2048;   // bursts resident in the ring
+constexpr int   particlesPerEmit     = 24;
+constexpr float particleLifetime[PARTICLE_KIND_COUNT] = { 0.35f, 0.9f };   // seconds
+
+struct ParticleStats {
+    int      resident;     // records in the ring, live or expired
+    int      instances;    // particles drawn last frame (expired ones collapse in the shader)
+    uint64_t emitted;
+    uint64_t dropped;      // queued while the render side wasn't keeping up
+};
+
+// After InitWindow(). Without GL 3.3 shaders the system stays off and emits are
+// ignored, as they are before init (headless).
+void InitParticles();
+void ShutdownParticles();
+
+// Any thread; one lock per call
+void QueueParticleEmits(const ParticleEmit* emits, size_t count);
+
+// Main thread, inside BeginMode3D(): uploads queued emits, then draws
+void DrawParticles();
+
+ParticleStats GetParticleStats();
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Frame profiler: scoped CPU timers per phase, kept for the last
+// profilerHistory frames. Compiled out in Release (NDEBUG) unless LIX_PROFILER
+// is defined, e.g. by the headless benchmark build.
+#if !defined(NDEBUG) || defined(LIX_PROFILER)
+    #define LIX_PROFILING 1
+#else
+    #define LIX_PROFILING 0
+#endif
+
+enum ProfilePhase {
+    PHASE_INPUT = 0,
+    PHASE_STREAMING,
+    PHASE_SPAWN,
+    PHASE_PLAYER,
+    PHASE_PROJECTILES,
+    PHASE_COMPACTION,
+    PHASE_ENEMIES,
+    PHASE_EVENTS,
+    PHASE_DRAW_WORLD,
+    PHASE_DRAW_HUD,
+    PHASE_COUNT
+};
+
+constexpr int profilerHistory = 240;
+
+struct PhaseSummary {
+    float avgMs;
+    float p99Ms;
+    float maxMs;
+};
+
+#if LIX_PROFILING
+
+struct Profiler {
+    float phaseMs[profilerHistory][PHASE_COUNT];  // ring buffer, one row per frame
+    float frameMs[profilerHistory];
+    std::atomic<uint64_t> currentNs[PHASE_COUNT]; // accumulating for the open frame; the
+                                                  // simulation thread adds to it too
+    int   head;                                   // next row to write
+    int   frames;                                 // rows filled so far (<= history)
+    bool  overlayVisible;
+    std::chrono::steady_clock::time_point frameStart;
+};
+
+extern Profiler profiler;
+
+// Closes the open frame into the ring buffer and starts a new one
+void ProfilerBeginFrame();
+void ProfilerAddSample(ProfilePhase phase, float ms);
+// Milliseconds the calling thread has recorded per phase since its last call
+// (telemetry reads the simulation thread's share this way)
+void ProfilerTakeThreadTotals(float outMs[PHASE_COUNT]);
+PhaseSummary ProfilerSummarize(ProfilePhase phase);
+PhaseSummary ProfilerSummarizeFrame();
+const char* ProfilerPhaseName(ProfilePhase phase);
+void ProfilerToggleOverlay();
+bool ProfilerOverlayVisible();
+void DrawProfilerOverlay(int x, int y);   // returns without drawing when hidden
+
+struct ScopedPhaseTimer {
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+
+    explicit ScopedPhaseTimer(ProfilePhase p) : phase(p), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhaseTimer() {
+        const auto end = std::chrono::steady_clock::now();
+        ProfilerAddSample(phase, std::chrono::duration<float, std::milli>(end - start).count());
+    }
+};
+
+#define LIX_PROFILE_CONCAT_(a, b) a##b
+#define LIX_PROFILE_CONCAT(a, b)  LIX_PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(phase) ScopedPhaseTimer LIX_PROFILE_CONCAT(profileScope, __LINE__)(phase)
+
+#else
+
+inline void ProfilerBeginFrame() {}
+inline void ProfilerAddSample(ProfilePhase, float) {}
+inline void ProfilerTakeThreadTotals(float outMs[PHASE_COUNT]) { for (int p = 0; p < PHASE_COUNT; ++p) outMs[p] = 0.0f; }
+inline PhaseSummary ProfilerSummarize(ProfilePhase) { return {}; }
+inline PhaseSummary ProfilerSummarizeFrame() { return {}; }
+inline const char* ProfilerPhaseName(ProfilePhase) { return ""; }
+inline void ProfilerToggleOverlay() {}
+inline bool ProfilerOverlayVisible() { return false; }
+inline void DrawProfilerOverlay(int, int) {}
+
+#define PROFILE_SCOPE(phase) ((void)0)
+
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#include "raylib.h"
+#include "entitypool.h"
+#include <cstddef>
+#include <vector>
+
+constexpr size_t projectileCapacity = 1 << 16;
+
+// Live projectiles in structure-of-arrays form. Indices [0, count) are live and
+// densely packed; removal swaps the last projectile into the hole. Storage is
+// sized once to the pool capacity so spawning never reallocates. The handle
+// table tracks which stable slot each dense index belongs to, so a handle from
+// SpawnProjectile keeps naming the same round while others come and go.
+struct ProjectilePool {
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> prevX, prevY, prevZ;   // position at the start of the tick
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> lifetime;
+    HandleTable handles;
+    float  radius;
+    size_t count;                             // == handles.count
+    size_t capacity;
+};
+
+void InitProjectilePool(ProjectilePool& pool, size_t capacity, float radius);
+void ClearProjectiles(ProjectilePool& pool);
+EntityHandle SpawnProjectile(ProjectilePool& pool, const Vector3& pos, const Vector3& vel, float lifetime);
+
+// prev = pos; pos += vel * dt; lifetime -= dt, vectorized over the live range
+void IntegrateProjectiles(ProjectilePool& pool, float dt);
+
+void RemoveProjectile(ProjectilePool& pool, size_t index);
+void RemoveDeadProjectiles(ProjectilePool& pool);
+
+// Dense index of a live projectile; false once it has been removed
+inline bool FindProjectile(const ProjectilePool& pool, EntityHandle h, size_t& index) {
+    uint32_t dense;
+    if (!ResolveHandle(pool.handles, h, dense)) return false;
+    index = dense;
+    return true;
+}
+
+inline Vector3 GetProjectilePosition(const ProjectilePool& pool, size_t i) {
+    return { pool.posX[i], pool.posY[i], pool.posZ[i] };
+}
+
+inline Vector3 GetProjectilePrevPosition(const ProjectilePool& pool, size_t i) {
+    return { pool.prevX[i], pool.prevY[i], pool.prevZ[i] };
+}
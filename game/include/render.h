@@ -0,0 +1,84 @@
+#pragma once
+#include "raylib.h"
+#include "assets.h"
+#include <cstdint>
+#include <vector>
+
+struct RenderSnapshot;
+
+// Per-frame counters for the world pass; "culled" counts objects considered but
+// rejected by the frustum or draw distance
+struct RenderStats {
+    int drawCalls;
+    int platformInstances;
+    int enemyInstances;
+    int enemyImpostors;
+    int projectileInstances;
+    int platformsCulled;
+    int enemiesCulled;
+    int projectilesCulled;
+    int tracers;
+};
+
+// Matches rlgl's default far clip (RL_CULL_DISTANCE_NEAR/FAR)
+constexpr float renderNearPlane = 0.01f;
+constexpr float renderFarPlane  = 1000.0f;
+
+// Enemy detail tiers by camera distance, each drawn as one instanced batch. The
+// mesh tier is the full model (for now the shared cube); impostors are
+// camera-facing quads textured with the enemy sprite.
+enum EnemyLod : uint8_t {
+    ENEMY_LOD_MESH = 0,
+    ENEMY_LOD_IMPOSTOR,
+    ENEMY_LOD_COUNT
+};
+
+constexpr float enemyImpostorDistance = 40.0f;
+constexpr float enemyLodHysteresis    = 0.1f;   // switch at distance * (1 +- this), so tiers don't flicker at the boundary
+constexpr const char* enemyImpostorTexture = "resources/mecha.png";
+
+// Instanced world renderer: one shared unit cube, one DrawMeshInstanced call per
+// entity category. Colour travels in the unused bottom row of each instance
+// matrix so a category with mixed colours is still a single draw.
+struct Renderer {
+    Shader   shader;
+    Material material;
+    Mesh     cube;
+    bool     instancing;                  // false -> immediate-mode fallback
+    float    maxDrawDistance;             // 0 = cull at the far plane only
+    RenderStats stats;
+
+    Shader   impostorShader;              // billboards the quad per instance
+    bool     impostors;                   // impostorShader is usable; false -> immediate-mode billboards
+    Material impostorMaterial;
+    Mesh     quad;
+    int      billboardRightLoc;
+    AssetHandle impostorSprite;           // loads in the background
+    bool     impostorTextured;            // false -> flat-tinted quads (until the sprite is in)
+    float    impostorDistance;            // 0 = always draw the mesh tier
+    std::vector<uint8_t>  enemyLod;       // tier per enemy slot, chosen for
+    std::vector<uint32_t> enemyLodGeneration;   // the enemy of this generation
+};
+
+extern Renderer renderer;
+
+void InitRenderer();
+void ShutdownRenderer();
+
+// Culls and draws the snapshot's platforms, enemies, projectiles and hitscan
+// tracers, interpolated by alpha across the tick it was taken after. Enemies
+// are split into their LOD tiers. Must be called inside
+// BeginMode3D(camera)/EndMode3D.
+void DrawWorldInstanced(const RenderSnapshot& snapshot, const Camera3D& camera, float alpha);
+
+// Affine box transform with the tint packed into m3/m7/m11/m15
+inline Matrix PackInstance(const Vector3& pos, const Vector3& size, Color c) {
+    Matrix m = {};
+    m.m0  = size.x; m.m5 = size.y; m.m10 = size.z;
+    m.m12 = pos.x;  m.m13 = pos.y; m.m14 = pos.z;
+    m.m3  = c.r / 255.0f;
+    m.m7  = c.g / 255.0f;
+    m.m11 = c.b / 255.0f;
+    m.m15 = c.a / 255.0f;
+    return m;
+}
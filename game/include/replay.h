@@ -0,0 +1,71 @@
+#pragma once
+#include "game.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Replays record a session as the setup it started from plus one TickInput per
+// tick, stored as deltas: a tick writes only the buttons that changed and any
+// mouse motion, and a run of identical ticks collapses to one byte. A state
+// checksum every checksumInterval ticks lets playback stop at the first tick
+// that diverges. Nothing else is stored; playback re-simulates.
+
+constexpr uint32_t replayMagic   = 0x5052584Cu;   // "LXRP" little-endian
+constexpr uint32_t replayVersion = 1;
+constexpr int      replayDefaultChecksumInterval = 60;
+
+// Everything besides input that shapes the simulation. Windowed sessions leave
+// the headless-only fields at zero.
+struct ReplaySetup {
+    uint32_t seed;
+    int32_t  tickRate;
+    int32_t  enemyLimit;
+    int32_t  weaponMode;           // at the first tick; Q presses are in the input
+    int32_t  checksumInterval;
+    int32_t  benchmarkPlatforms;   // headless: crates scattered after the level loads
+    float    floorSize;            // headless: floor resize before scattering, 0 = keep
+    int32_t  fillEnemies;          // headless: enemies spawned at start and on restart
+    int32_t  immortal;             // headless: health pinned to 100 before each tick
+    char     level[256];           // level file, empty for the built-in arena
+};
+
+struct ReplayWriter {
+    FILE*    file;
+    std::vector<uint8_t> buffer;   // flushed well before it would have to grow
+    TickInput last;
+    uint32_t repeat;               // ticks identical to last, not yet written
+    uint64_t ticks;
+    int      checksumInterval;
+};
+
+bool ReplayBeginRecording(ReplayWriter& writer, const char* path, const ReplaySetup& setup);
+// Call before simulating the tick; restarted = the game was reset since the last one
+void ReplayRecordTick(ReplayWriter& writer, const TickInput& input, bool restarted);
+// True right after a tick that ends a checksum interval
+bool ReplayChecksumDue(const ReplayWriter& writer);
+// Call after simulating the tick; writes the checksum when one is due
+void ReplayRecordChecksum(ReplayWriter& writer, uint64_t checksum);
+void ReplayEndRecording(ReplayWriter& writer);
+bool ReplayRecording(const ReplayWriter& writer);
+
+struct ReplayReader {
+    ReplaySetup setup;
+    std::vector<uint8_t> data;     // record stream after the header
+    size_t   cursor;
+    TickInput last;
+    uint32_t repeat;               // ticks of last still to hand out
+    uint64_t ticks;
+    uint64_t checksumsVerified;
+};
+
+bool LoadReplay(ReplayReader& reader, const char* path);
+
+// Next tick's input. Returns false at the end of the recording.
+bool NextReplayTick(ReplayReader& reader, TickInput& input, bool& restarted);
+
+// Call after simulating the tick: whether the recording holds a checksum for it,
+// so the caller only hashes the state when there is something to compare
+bool ReplayChecksumPending(const ReplayReader& reader);
+// Returns false when the recording holds a checksum for this tick and it
+// differs from `checksum`; expected is set then.
+bool VerifyReplayChecksum(ReplayReader& reader, uint64_t checksum, uint64_t& expected);
@@ -0,0 +1,90 @@
+#pragma once
+#include "entitypool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Player;
+struct World;
+
+// Save states hold everything the simulation needs to resume mid-game: the
+// player, every enemy and round, and the few globals beside them (timers, the
+// spawn stream). The level is not included, only a fingerprint of it, and
+// neither is anything derived per tick (grids, flow field, render history).
+//
+// Values are quantized onto fixed steps and kept as int32 records, so a state
+// compares and diffs exactly. Encoding is against a baseline: each record
+// writes a mask of the fields that differ from its counterpart there and the
+// differences as zigzag varints. A full state is encoded against an all-zero
+// baseline, so quick-saves, rollback and network deltas share one path.
+
+constexpr uint32_t saveStateMagic   = 0x5353584Cu;   // "LXSS" little-endian
+constexpr uint16_t saveStateVersion = 2;
+
+constexpr float savePositionStep = 1.0f / 1024.0f;    // metres
+constexpr float saveVelocityStep = 1.0f / 256.0f;     // metres per second
+constexpr float saveAngleStep    = 1.0f / 16384.0f;   // radians
+constexpr float saveTimeStep     = 1.0f / 1000.0f;    // seconds
+
+// Filled in by the game (game.cpp), which owns these
+enum SaveGlobalField {
+    SAVE_GLOBAL_LEVEL = 0,        // fingerprint of the level the state belongs to
+    SAVE_GLOBAL_SEED,
+    SAVE_GLOBAL_RNG_0,            // spawn stream state, the four xoshiro words
+    SAVE_GLOBAL_RNG_1,
+    SAVE_GLOBAL_RNG_2,
+    SAVE_GLOBAL_RNG_3,
+    SAVE_GLOBAL_WAVE,
+    SAVE_GLOBAL_WAVE_TIMER,
+    SAVE_GLOBAL_WAVE_PENDING,
+    SAVE_GLOBAL_ENEMY_LIMIT,
+    SAVE_GLOBAL_WEAPON_MODE,
+    SAVE_GLOBAL_GAME_OVER,
+    SAVE_GLOBAL_COUNT
+};
+
+constexpr int savePlayerFields = 17;
+constexpr int saveEnemyFields  = 9;
+constexpr int saveRoundFields  = 7;
+
+struct SaveState {
+    uint64_t tick;
+    int32_t  globals[SAVE_GLOBAL_COUNT];
+    int32_t  player[savePlayerFields];
+    std::vector<EntityHandle> enemyHandles;   // dense order; enemies keep their identity
+    std::vector<int32_t> enemies;             // saveEnemyFields per enemy, same order
+    std::vector<int32_t> rounds;              // saveRoundFields per round; rounds are anonymous
+};
+
+inline int32_t QuantizeValue(float v, float step) {
+    const float q = v / step;
+    if (q >= 2147483520.0f) return INT32_MAX;
+    if (q <= -2147483520.0f) return INT32_MIN;
+    return (int32_t)(q < 0.0f ? q - 0.5f : q + 0.5f);
+}
+
+inline float DequantizeValue(int32_t q, float step) {
+    return (float)q * step;
+}
+
+// Player, enemies and rounds, quantized. Capture reuses the state's storage.
+void CaptureEntities(SaveState& state, const Player& player, const World& world);
+
+// Writes the captured player, enemies and rounds back. The enemy pool must
+// already have the capacity the state was taken with. Returns false, leaving
+// the pools cleared, if an enemy handle doesn't fit the pool.
+bool RestoreEntities(const SaveState& state, Player& player, World& world);
+
+bool SaveStatesEqual(const SaveState& a, const SaveState& b);
+
+// Appends the encoding of state to out. With a baseline only what changed
+// since it is written, and decoding needs that same baseline.
+void EncodeSaveState(const SaveState& state, const SaveState* baseline, std::vector<uint8_t>& out);
+
+// Returns false on malformed data, a version mismatch, or when data is a delta
+// and baseline is missing or isn't the state (by tick) it was encoded against.
+bool DecodeSaveState(const uint8_t* data, size_t size, const SaveState* baseline, SaveState& state);
+
+// Full states on disk (quick-save)
+bool WriteSaveStateFile(const char* path, const SaveState& state);
+bool ReadSaveStateFile(const char* path, SaveState& state);
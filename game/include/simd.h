@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+
+// Thin wrapper over the widest float vector the target was compiled for.
+// AVX is opt-in (premake --simd-avx); SSE2 is the x86-64 baseline; NEON covers
+// AArch64. Define LIX_NO_SIMD to force the scalar path.
+#if !defined(LIX_NO_SIMD) && defined(__AVX__)
+    #include <immintrin.h>
+    #define LIX_SIMD_AVX 1
+#elif !defined(LIX_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define LIX_SIMD_SSE 1
+#elif !defined(LIX_NO_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+    #include <arm_neon.h>
+    #define LIX_SIMD_NEON 1
+#else
+    #define LIX_SIMD_SCALAR 1
+#endif
+
+namespace simd {
+
+#if defined(LIX_SIMD_AVX)
+using f32 = __m256;
+constexpr int width = 8;
+inline f32 load(const float* p)         { return _mm256_loadu_ps(p); }
+inline void store(float* p, f32 v)      { _mm256_storeu_ps(p, v); }
+inline f32 set1(float v)                { return _mm256_set1_ps(v); }
+inline f32 add(f32 a, f32 b)            { return _mm256_add_ps(a, b); }
+inline f32 sub(f32 a, f32 b)            { return _mm256_sub_ps(a, b); }
+inline f32 mul(f32 a, f32 b)            { return _mm256_mul_ps(a, b); }
+inline f32 min(f32 a, f32 b)            { return _mm256_min_ps(a, b); }
+inline f32 max(f32 a, f32 b)            { return _mm256_max_ps(a, b); }
+inline f32 cmple(f32 a, f32 b)          { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline f32 cmplt(f32 a, f32 b)          { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline f32 bitand_(f32 a, f32 b)        { return _mm256_and_ps(a, b); }
+inline uint32_t movemask(f32 m)         { return (uint32_t)_mm256_movemask_ps(m); }
+#elif defined(LIX_SIMD_SSE)
+using f32 = __m128;
+constexpr int width = 4;
+inline f32 load(const float* p)         { return _mm_loadu_ps(p); }
+inline void store(float* p, f32 v)      { _mm_storeu_ps(p, v); }
+inline f32 set1(float v)                { return _mm_set1_ps(v); }
+inline f32 add(f32 a, f32 b)            { return _mm_add_ps(a, b); }
+inline f32 sub(f32 a, f32 b)            { return _mm_sub_ps(a, b); }
+inline f32 mul(f32 a, f32 b)            { return _mm_mul_ps(a, b); }
+inline f32 min(f32 a, f32 b)            { return _mm_min_ps(a, b); }
+inline f32 max(f32 a, f32 b)            { return _mm_max_ps(a, b); }
+inline f32 cmple(f32 a, f32 b)          { return _mm_cmple_ps(a, b); }
+inline f32 cmplt(f32 a, f32 b)          { return _mm_cmplt_ps(a, b); }
+inline f32 bitand_(f32 a, f32 b)        { return _mm_and_ps(a, b); }
+inline uint32_t movemask(f32 m)         { return (uint32_t)_mm_movemask_ps(m); }
+#elif defined(LIX_SIMD_NEON)
+using f32 = float32x4_t;
+constexpr int width = 4;
+inline f32 load(const float* p)         { return vld1q_f32(p); }
+inline void store(float* p, f32 v)      { vst1q_f32(p, v); }
+inline f32 set1(float v)                { return vdupq_n_f32(v); }
+inline f32 add(f32 a, f32 b)            { return vaddq_f32(a, b); }
+inline f32 sub(f32 a, f32 b)            { return vsubq_f32(a, b); }
+inline f32 mul(f32 a, f32 b)            { return vmulq_f32(a, b); }
+inline f32 min(f32 a, f32 b)            { return vminq_f32(a, b); }
+inline f32 max(f32 a, f32 b)            { return vmaxq_f32(a, b); }
+inline f32 cmple(f32 a, f32 b)          { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline f32 cmplt(f32 a, f32 b)          { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline f32 bitand_(f32 a, f32 b)        { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline uint32_t movemask(f32 m) {
+    static const int32_t shifts[4] = { 0, 1, 2, 3 };
+    const uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(m), 31);
+    return vaddvq_u32(vshlq_u32(bits, vld1q_s32(shifts)));
+}
+#else
+using f32 = float;
+constexpr int width = 1;
+inline f32 load(const float* p)         { return *p; }
+inline void store(float* p, f32 v)      { *p = v; }
+inline f32 set1(float v)                { return v; }
+inline f32 add(f32 a, f32 b)            { return a + b; }
+inline f32 sub(f32 a, f32 b)            { return a - b; }
+inline f32 mul(f32 a, f32 b)            { return a * b; }
+inline f32 min(f32 a, f32 b)            { return a < b ? a : b; }
+inline f32 max(f32 a, f32 b)            { return a > b ? a : b; }
+inline f32 cmple(f32 a, f32 b)          { return a <= b ? 1.0f : 0.0f; }
+inline f32 cmplt(f32 a, f32 b)          { return a < b ? 1.0f : 0.0f; }
+inline f32 bitand_(f32 a, f32 b)        { return (a != 0.0f && b != 0.0f) ? 1.0f : 0.0f; }
+inline uint32_t movemask(f32 m)         { return m != 0.0f ? 1u : 0u; }
+#endif
+
+} // namespace simd
@@ -0,0 +1,72 @@
+#pragma once
+#include "game.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Immutable copy of the platform set for the render thread, rebuilt by the
+// simulation whenever World::platformsVersion changes and shared by every
+// snapshot taken while that version is current.
+struct PlatformRenderSet {
+    uint32_t version;
+    std::vector<Platform> platforms;
+    std::vector<Matrix>   transforms;    // instance matrix per platform
+    PlatformGrid grid;                   // culling index over platforms
+};
+
+struct EnemyView {
+    EntityHandle handle;                 // lets the renderer keep per-enemy state (LOD tier)
+    Vector3 prevPosition;
+    Vector3 position;
+    Vector3 size;
+    bool    flashing;
+};
+
+struct RoundView {
+    Vector3 prevPosition;
+    Vector3 position;
+};
+
+// Numbers for the F3 overlay
+struct SnapshotDebug {
+    SpatialQueryStats platformQueryStats;
+    SpatialQueryStats enemyQueryStats;
+    int      flowCellsX, flowCellsZ;
+    uint64_t flowRebuilds;
+    size_t   enemyCapacity;
+    EntityHandle lastHitEnemy;
+    int      lastHitHealth;              // -1 once the enemy is gone
+    bool     streaming;
+    StreamStats stream;
+};
+
+// Everything GameDraw() needs from one simulation tick. The simulation fills a
+// snapshot after each tick and hands it over through a TripleBuffer, so the
+// render thread never reads World or Player directly.
+struct RenderSnapshot {
+    bool     valid;                      // false until the first tick is published
+    uint64_t tick;
+    std::chrono::steady_clock::time_point publishedAt;
+    float    tickDt;
+
+    Camera3D camera;
+    Vector3  eyePrev;                    // player position at the start and end of the tick
+    Vector3  eye;
+
+    std::shared_ptr<const PlatformRenderSet> platforms;
+    std::vector<EnemyView> enemies;
+    std::vector<RoundView> rounds;
+    float    roundRadius;
+    Tracer   tracers[tracerCapacity];
+
+    // HUD
+    int   health;
+    int   enemiesDefeated;
+    int   shotsFired;
+    int   shotsHit;
+    float survivalTime;
+    WeaponMode weaponMode;
+    bool  gameOver;
+
+    SnapshotDebug debug;
+};
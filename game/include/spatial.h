@@ -0,0 +1,176 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+struct Platform;
+struct Enemy;
+
+// Running totals for broadphase queries; lastQueryCandidates is the number of
+// platforms the most recent query handed to its narrowphase test.
+struct SpatialQueryStats {
+    uint64_t queries;
+    uint64_t candidatesTested;
+    uint32_t lastQueryCandidates;
+};
+
+// Axis-aligned rectangle on the XZ plane
+struct XZBounds {
+    float minX;
+    float minZ;
+    float maxX;
+    float maxZ;
+};
+
+// Static uniform grid over the XZ footprint of the level's platforms. Built once
+// after the platform list is known; queries are read-only so they are safe to run
+// from several threads at once. Queries read through the pointers, which refer
+// either to the grid's own storage (BuildPlatformGrid) or to a compiled level
+// file mapped in place (level.h), so a grid must not be copied.
+struct PlatformGrid {
+    float originX     = 0.0f;
+    float originZ     = 0.0f;
+    float cellSize    = 0.0f;
+    float invCellSize = 0.0f;
+    int   cellsX      = 0;
+    int   cellsZ      = 0;
+    const uint32_t* cellStart    = nullptr;  // cellsX * cellsZ + 1 offsets into cellItems
+    const uint32_t* cellItems    = nullptr;  // platform indices grouped by cell
+    const int32_t*  itemCellMinX = nullptr;  // first cell each platform touches, used to
+    const int32_t*  itemCellMinZ = nullptr;  // report multi-cell platforms exactly once
+    const uint32_t* largeItems   = nullptr;  // platforms too big to bin (e.g. the floor)
+    uint32_t cellItemCount  = 0;
+    uint32_t largeItemCount = 0;
+
+    // Backing storage when built at runtime
+    std::vector<uint32_t> cellStartData;
+    std::vector<uint32_t> cellItemsData;
+    std::vector<int32_t>  itemCellMinXData;
+    std::vector<int32_t>  itemCellMinZData;
+    std::vector<uint32_t> largeItemsData;
+
+    PlatformGrid() = default;
+    PlatformGrid(const PlatformGrid&) = delete;
+    PlatformGrid& operator=(const PlatformGrid&) = delete;
+};
+
+constexpr float platformGridCellSize     = 4.0f;
+constexpr int   platformGridMaxItemCells = 64;
+
+// The grid covers every platform, or only `clip` when given; platforms reaching
+// past the clip rectangle are binned into its edge cells, which queries clamp to
+// as well, so results stay exact.
+void BuildPlatformGrid(PlatformGrid& grid, const Platform* platforms, size_t count,
+                       float cellSize = platformGridCellSize, const XZBounds* clip = nullptr);
+
+// Cell coordinate of v, clamped to [0, cells - 1] before the int conversion
+inline int GridCellCoord(float v, float origin, float invCellSize, int cells) {
+    const float c = (v - origin) * invCellSize;
+    if (c <= 0.0f) return 0;
+    if (c >= (float)(cells - 1)) return cells - 1;
+    return (int)c;
+}
+
+inline void AddQueryStats(SpatialQueryStats& stats, uint32_t candidates) {
+    stats.queries++;
+    stats.candidatesTested   += candidates;
+    stats.lastQueryCandidates = candidates;
+}
+
+// Calls fn(platformIndex) for every platform whose cells overlap the XZ rectangle,
+// each platform at most once. fn returns true to stop early. Returns the number of
+// candidates visited.
+template <typename Fn>
+inline uint32_t QueryPlatformGrid(const PlatformGrid& grid,
+                                  float minX, float minZ, float maxX, float maxZ,
+                                  Fn&& fn) {
+    uint32_t tested = 0;
+
+    for (uint32_t l = 0; l < grid.largeItemCount; ++l) {
+        const uint32_t index = grid.largeItems[l];
+        ++tested;
+        if (fn(index)) return tested;
+    }
+
+    if (grid.cellsX <= 0 || grid.cellsZ <= 0) return tested;
+
+    const int c0x = GridCellCoord(minX, grid.originX, grid.invCellSize, grid.cellsX);
+    const int c0z = GridCellCoord(minZ, grid.originZ, grid.invCellSize, grid.cellsZ);
+    const int c1x = GridCellCoord(maxX, grid.originX, grid.invCellSize, grid.cellsX);
+    const int c1z = GridCellCoord(maxZ, grid.originZ, grid.invCellSize, grid.cellsZ);
+
+    for (int cz = c0z; cz <= c1z; ++cz) {
+        for (int cx = c0x; cx <= c1x; ++cx) {
+            const int cell = cz * grid.cellsX + cx;
+            for (uint32_t i = grid.cellStart[cell]; i < grid.cellStart[cell + 1]; ++i) {
+                const uint32_t index = grid.cellItems[i];
+                // Only the first overlapped cell reports a platform spanning several
+                if (cx != std::max(grid.itemCellMinX[index], c0x) ||
+                    cz != std::max(grid.itemCellMinZ[index], c0z))
+                    continue;
+                ++tested;
+                if (fn(index)) return tested;
+            }
+        }
+    }
+    return tested;
+}
+
+// Dynamic spatial hash over enemy XZ positions, rebuilt with a counting sort each
+// time enemies move. Each enemy is binned by its centre cell only, so queries
+// must pad their rectangle by the largest enemy half extent.
+struct EnemyGrid {
+    float cellSize;
+    float invCellSize;
+    uint32_t bucketMask;                 // bucket count - 1 (power of two)
+    std::vector<uint32_t> bucketStart;   // bucket count + 1 offsets into entries
+    std::vector<uint32_t> entries;       // enemy indices grouped by bucket
+    std::vector<int32_t>  cellX;         // centre cell of each enemy, to reject
+    std::vector<int32_t>  cellZ;         // bucket collisions and duplicate visits
+    std::vector<uint32_t> bucketOf;      // scratch: bucket of each enemy
+};
+
+constexpr float enemyGridCellSize = 2.0f;
+
+void RebuildEnemyGrid(EnemyGrid& grid, const Enemy* enemies, size_t count,
+                      float cellSize = enemyGridCellSize);
+
+// Sizes the grid's storage for up to maxCount enemies so rebuilds don't allocate
+void ReserveEnemyGrid(EnemyGrid& grid, size_t maxCount);
+
+inline int WorldToCell(float v, float invCellSize) {
+    return (int)std::floor(v * invCellSize);
+}
+
+inline uint32_t HashCell(int cx, int cz, uint32_t mask) {
+    return ((uint32_t)cx * 73856093u ^ (uint32_t)cz * 19349663u) & mask;
+}
+
+// Calls fn(enemyIndex) for every enemy whose centre lies in a cell overlapping the
+// XZ rectangle. fn returns true to stop early. Returns the number of candidates.
+template <typename Fn>
+inline uint32_t QueryEnemyGrid(const EnemyGrid& grid,
+                               float minX, float minZ, float maxX, float maxZ,
+                               Fn&& fn) {
+    if (grid.entries.empty()) return 0;
+
+    const int c0x = WorldToCell(minX, grid.invCellSize);
+    const int c0z = WorldToCell(minZ, grid.invCellSize);
+    const int c1x = WorldToCell(maxX, grid.invCellSize);
+    const int c1z = WorldToCell(maxZ, grid.invCellSize);
+
+    uint32_t tested = 0;
+    for (int cz = c0z; cz <= c1z; ++cz) {
+        for (int cx = c0x; cx <= c1x; ++cx) {
+            const uint32_t bucket = HashCell(cx, cz, grid.bucketMask);
+            for (uint32_t i = grid.bucketStart[bucket]; i < grid.bucketStart[bucket + 1]; ++i) {
+                const uint32_t index = grid.entries[i];
+                if (grid.cellX[index] != cx || grid.cellZ[index] != cz) continue;
+                ++tested;
+                if (fn(index)) return tested;
+            }
+        }
+    }
+    return tested;
+}
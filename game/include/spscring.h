@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Single-producer single-consumer ring of fixed capacity (a power of two).
+// Push() and Pop() each touch only their own index plus an acquire load of the
+// other's, so neither side ever blocks; a full ring rejects the push rather
+// than make the producer wait. Slots are stored inline, so nothing allocates.
+template <typename T, uint32_t Capacity>
+struct SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static constexpr uint32_t mask = Capacity - 1;
+
+    T slots[Capacity];
+    alignas(64) std::atomic<uint32_t> head{ 0 };   // next slot to write (producer)
+    alignas(64) std::atomic<uint32_t> tail{ 0 };   // next slot to read (consumer)
+
+    // Producer side. Returns false, dropping the value, when the ring is full.
+    bool Push(const T& value) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity) return false;
+        slots[h & mask] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool Pop(T& value) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        value = slots[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
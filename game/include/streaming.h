@@ -0,0 +1,78 @@
+#pragma once
+#include "level.h"
+#include <cstdint>
+#include <vector>
+
+// Chunked level streaming. A streamed level (.lxs) splits its platforms into
+// square XZ chunks; a background thread loads the chunks within the stream
+// radius of the player and the simulation only ever sees the base platforms
+// (the floor and anything larger than a chunk) plus the resident chunks.
+// Resident memory is bounded by the radius, not by the size of the level.
+
+constexpr float streamChunkSize     = 32.0f;
+constexpr float streamDefaultRadius = 64.0f;
+
+// -----------------------------------------------------------------------------
+// File format (.lxs): header, base platform records, a chunk table, then each
+// chunk's Platform records back to back. Native byte order, like .lxl.
+// -----------------------------------------------------------------------------
+constexpr char     streamFileMagic[4] = { 'L', 'X', 'S', 'T' };
+constexpr uint32_t streamFileVersion  = 1;
+
+struct StreamFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t platformStride;       // sizeof(Platform) at compile time
+    float    chunkSize;
+    uint32_t basePlatformCount;    // always resident; [0] is the floor
+    uint32_t chunkCount;
+    uint64_t basePlatformsOffset;
+    uint64_t chunkTableOffset;
+    uint64_t fileSize;
+};
+
+struct StreamChunkEntry {
+    int32_t  chunkX;
+    int32_t  chunkZ;
+    uint32_t platformCount;
+    uint32_t reserved;
+    uint64_t offset;               // first Platform record of the chunk
+};
+
+struct StreamStats {
+    int      residentChunks;
+    int      pendingChunks;        // requested, not yet delivered
+    uint64_t loads;
+    uint64_t unloads;
+    size_t   residentPlatforms;
+};
+
+// Platforms go to the chunk holding their centre; the first platform and any
+// platform wider than a chunk become base platforms
+bool WriteStreamedLevel(const char* path, const Platform* platforms, size_t count,
+                        float chunkSize = streamChunkSize);
+bool IsStreamedLevel(const char* path);
+
+// Opening starts the loader thread unless the stream is synchronous
+bool StreamOpen(const char* path);
+void StreamClose();
+bool StreamActive();
+
+void StreamSetRadius(float meters);
+// Synchronous streams load on the calling thread inside StreamUpdate(), so runs
+// are reproducible (headless benchmark, replays)
+void StreamSetSynchronous(bool synchronous);
+
+// Requests chunks around (x, z), drops those beyond the radius and takes in
+// finished loads. wait = true blocks until every wanted chunk is resident.
+// Returns true when the resident set changed.
+bool StreamUpdate(float x, float z, bool wait);
+
+// Base platforms followed by resident chunks in a stable order, and the XZ area
+// they cover
+void StreamGatherResident(std::vector<Platform>& platforms, XZBounds& area);
+
+// First base platform; only valid while a stream is open
+const Platform& StreamFloor();
+
+StreamStats StreamGetStats();
@@ -0,0 +1,56 @@
+#pragma once
+#include "profiler.h"
+#include <cstdint>
+
+// Telemetry: the simulation periodically pushes a sample of its counters into
+// a lock-free ring, and a background thread drains the ring every
+// telemetryFlushMs and writes the samples out. The tick never waits on the
+// file or the socket. If the writer falls behind and the ring fills, samples
+// are dropped and counted.
+//
+// Targets: "udp://host:port" sends one JSON object per datagram; a path ending
+// in .csv gets a header row then one row per sample; any other path gets JSON
+// lines.
+
+// Phases the simulation thread times, contiguous in ProfilePhase
+constexpr int telemetryFirstPhase = PHASE_STREAMING;
+constexpr int telemetryPhaseCount = PHASE_EVENTS - PHASE_STREAMING + 1;
+
+constexpr int      telemetrySampleTicks  = 6;      // one sample per this many ticks
+constexpr uint32_t telemetryRingCapacity = 1024;   // samples
+constexpr int      telemetryFlushMs      = 250;
+
+struct TelemetrySample {
+    uint64_t tick;
+    double   seconds;            // since TelemetryOpen()
+    int32_t  health;
+    int32_t  enemiesDefeated;
+    int32_t  shotsFired;
+    int32_t  shotsHit;
+    float    survivalTime;
+    int32_t  wave;
+    uint32_t enemies;
+    uint32_t rounds;
+    float    tickMs;             // mean over the ticks since the last sample
+    float    tickMsMax;
+    float    phaseMs[telemetryPhaseCount];   // mean per tick, same ticks
+    uint64_t allocations;        // simulation-thread heap allocations, same ticks (tracking builds)
+};
+
+struct TelemetryStats {
+    uint64_t submitted;
+    uint64_t dropped;
+    uint64_t written;
+    uint64_t bytes;
+};
+
+// Starts the writer thread; false if the target can't be opened
+bool TelemetryOpen(const char* target);
+// Writes whatever is still queued, then stops the writer
+void TelemetryClose();
+bool TelemetryActive();
+
+// From one producer thread at a time (the one running the ticks)
+void TelemetrySubmit(const TelemetrySample& sample);
+
+TelemetryStats GetTelemetryStats();
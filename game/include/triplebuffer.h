@@ -0,0 +1,33 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Single-producer single-consumer triple buffer. The writer always owns one slot
+// to fill and the reader one slot to read; Publish() and Acquire() trade a slot
+// with the shared middle one in a single atomic exchange, so neither side ever
+// waits for the other. The reader sees the newest published value and skips any
+// it was too slow for; slot storage is reused, so nothing is allocated per swap.
+template <typename T>
+struct TripleBuffer {
+    static constexpr uint8_t indexMask = 3;
+    static constexpr uint8_t freshBit  = 4;   // middle holds a value the reader hasn't taken
+
+    T slots[3];
+    std::atomic<uint8_t> middle{ 1 };
+    uint8_t back  = 0;    // writer's slot
+    uint8_t front = 2;    // reader's slot
+
+    // Writer side. The slot holds whatever was written two publishes ago.
+    T& WriteSlot() { return slots[back]; }
+    void Publish() {
+        back = middle.exchange((uint8_t)(back | freshBit), std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader side. Returns true when a newer value replaced ReadSlot().
+    bool Acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & freshBit)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+    const T& ReadSlot() const { return slots[front]; }
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "raylib.h"
+#include "flowfield.h"
+#include "spatial.h"
+#include "xoshiro.h"
+#include <cstdint>
+
+// Wave director: enemies arrive in waves that grow each time, rather than one
+// at a time. A wave is deployed over a few ticks, waveBurstPerTick at a time,
+// into the enemy pool reserved at reset, so even a wave of several hundred
+// never allocates or lands on a single tick.
+struct WaveDirector {
+    int   wave;       // waves started so far
+    float timer;      // seconds until the next wave starts
+    int   pending;    // enemies of the current wave not yet placed
+};
+
+constexpr float waveFirstDelay       = 2.0f;
+constexpr float waveInterval         = 12.0f;   // from the start of one wave to the next
+constexpr int   waveBaseSize         = 4;
+constexpr int   waveGrowth           = 3;       // extra enemies per wave
+constexpr int   waveBurstPerTick     = 64;
+constexpr float waveMinSpawnDistance = 8.0f;    // from the player
+constexpr int   waveSpawnTries       = 8;       // candidate cells per enemy
+
+inline int WaveSize(int wave) {
+    return waveBaseSize + waveGrowth * wave;
+}
+
+inline void ResetWaveDirector(WaveDirector& director) {
+    director = { 0, waveFirstDelay, 0 };
+}
+
+// How many enemies to place this tick, with room free slots in the pool. A
+// wave that starts with less room than its size is trimmed to fit.
+int StepWaveDirector(WaveDirector& director, float dt, int room);
+
+// Fills out[0, count) with spawn positions (x, z) inside area shrunk by
+// margin. Each is a random walkable flow-field cell at least minDistance from
+// the player, preferring cells that have a route to the player. Without a
+// built field, or when every try misses, a point is uniform over the area.
+void PickSpawnPoints(const FlowField& field, Xoshiro128& rng, const XZBounds& area, float margin,
+                     float playerX, float playerZ, float minDistance, int count, Vector2* out);
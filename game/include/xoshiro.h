@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+
+// xoshiro128** (Blackman & Vigna): four words of state, a handful of ALU ops
+// per draw and no allocation, so batches of spawn positions cost next to
+// nothing. Seeded through splitmix64 so nearby seeds give unrelated streams.
+// The four words are the whole state, so a save state stores them as they are.
+struct Xoshiro128 {
+    uint32_t s[4];
+};
+
+inline void SeedXoshiro(Xoshiro128& rng, uint64_t seed) {
+    for (int i = 0; i < 4; i += 2) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        rng.s[i]     = (uint32_t)z;
+        rng.s[i + 1] = (uint32_t)(z >> 32);
+    }
+}
+
+inline Xoshiro128 MakeXoshiro(uint64_t seed) {
+    Xoshiro128 rng;
+    SeedXoshiro(rng, seed);
+    return rng;
+}
+
+inline uint32_t NextXoshiro(Xoshiro128& rng) {
+    uint32_t* s = rng.s;
+    auto rotl = [](uint32_t x, int k) { return (x << k) | (x >> (32 - k)); };
+    const uint32_t result = rotl(s[1] * 5u, 7) * 9u;
+    const uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+}
+
+// [0, 1) on a 2^-24 grid, exact in a float
+inline float XoshiroFloat(Xoshiro128& rng) {
+    return (float)(NextXoshiro(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+inline float XoshiroRange(Xoshiro128& rng, float min, float max) {
+    return min + (max - min) * XoshiroFloat(rng);
+}
+
+// [0, n) by multiply-shift; the bias is below 2^-32 * n, fine for picking cells
+inline uint32_t XoshiroIndex(Xoshiro128& rng, uint32_t n) {
+    return (uint32_t)(((uint64_t)NextXoshiro(rng) * n) >> 32);
+}
@@ -0,0 +1,103 @@
+#include "input.h"
+#include <cstdio>
+#include <cstring>
+
+// -----------------------------------------------------------------------------
+// Live input
+// -----------------------------------------------------------------------------
+void LatchLiveInput(TickInput& pending) {
+    const Vector2 mouseDelta = GetMouseDelta();
+    pending.mouseDelta.x += mouseDelta.x;
+    pending.mouseDelta.y += mouseDelta.y;
+    pending.moveForward = IsKeyDown(KEY_W);
+    pending.moveBack    = IsKeyDown(KEY_S);
+    pending.moveLeft    = IsKeyDown(KEY_A);
+    pending.moveRight   = IsKeyDown(KEY_D);
+    pending.running     = IsKeyDown(KEY_LEFT_SHIFT);
+    pending.crouching   = IsKeyDown(KEY_C);
+    pending.jumpPressed = pending.jumpPressed || IsKeyPressed(KEY_SPACE);
+    pending.firePressed = pending.firePressed || IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    pending.switchWeaponPressed = pending.switchWeaponPressed || IsKeyPressed(KEY_Q);
+}
+
+void ConsumeTickInput(TickInput& pending) {
+    pending.mouseDelta  = { 0.0f, 0.0f };
+    pending.jumpPressed = false;
+    pending.firePressed = false;
+    pending.switchWeaponPressed = false;
+}
+
+// -----------------------------------------------------------------------------
+// Scripted input
+// -----------------------------------------------------------------------------
+static TickInput ParseFlags(const char* flags, float dx, float dy) {
+    TickInput in = {};
+    in.mouseDelta = { dx, dy };
+    for (const char* c = flags; *c; ++c) {
+        switch (*c) {
+            case 'W': in.moveForward = true; break;
+            case 'S': in.moveBack    = true; break;
+            case 'A': in.moveLeft    = true; break;
+            case 'D': in.moveRight   = true; break;
+            case 'R': in.running     = true; break;
+            case 'C': in.crouching   = true; break;
+            case 'J': in.jumpPressed = true; break;
+            case 'F': in.firePressed = true; break;
+            case 'Q': in.switchWeaponPressed = true; break;
+            default: break;
+        }
+    }
+    return in;
+}
+
+bool LoadInputScript(InputScript& script, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    script = {};
+    script.loop = true;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (char* comment = strchr(line, '#')) *comment = '\0';
+
+        int ticks = 0;
+        char flags[32] = {};
+        float dx = 0.0f, dy = 0.0f;
+        if (sscanf(line, "%d %31s %f %f", &ticks, flags, &dx, &dy) < 2 || ticks <= 0)
+            continue;
+        script.steps.push_back({ ticks, ParseFlags(flags, dx, dy) });
+    }
+    fclose(file);
+    return !script.steps.empty();
+}
+
+void MakeDefaultInputScript(InputScript& script) {
+    script = {};
+    script.loop = true;
+    script.steps = {
+        { 120, ParseFlags("WF",  4.0f,  0.0f) },
+        {  60, ParseFlags("WDRF", 6.0f,  0.5f) },
+        {  30, ParseFlags("WRCF", 2.0f,  0.0f) },   // slide
+        {  90, ParseFlags("SAF", -5.0f, -0.5f) },
+        {  20, ParseFlags("WJF",  0.0f,  0.0f) },
+        { 120, ParseFlags("DF",   3.0f,  0.0f) },
+    };
+}
+
+TickInput NextScriptedInput(InputScript& script) {
+    if (script.steps.empty()) return {};
+
+    if (script.step >= script.steps.size()) {
+        if (!script.loop) return {};
+        script.step = 0;
+    }
+
+    const InputScriptStep& current = script.steps[script.step];
+    const TickInput in = current.input;
+    if (++script.tickInStep >= current.ticks) {
+        script.tickInStep = 0;
+        script.step++;
+    }
+    return in;
+}
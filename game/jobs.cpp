@@ -0,0 +1,177 @@
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job {
+    JobFn  fn;
+    void*  ctx;
+    size_t begin;
+    size_t end;
+    std::atomic<int>* pending;
+};
+
+// Double-ended ring: the owner takes from the back, thieves from the front.
+// Grows only when a ParallelFor deals more chunks than it has ever held, so
+// steady-state ticks don't allocate.
+struct WorkerQueue {
+    std::mutex       mutex;
+    std::vector<Job> ring;
+    size_t           head = 0;
+    size_t           count = 0;
+
+    void PushBack(const Job& job) {
+        if (count == ring.size()) {
+            std::vector<Job> grown(std::max<size_t>(16, ring.size() * 2));
+            for (size_t i = 0; i < count; ++i) grown[i] = ring[(head + i) % ring.size()];
+            ring.swap(grown);
+            head = 0;
+        }
+        ring[(head + count++) % ring.size()] = job;
+    }
+    Job PopBack() {
+        return ring[(head + --count) % ring.size()];
+    }
+    Job PopFront() {
+        const Job job = ring[head];
+        head = (head + 1) % ring.size();
+        --count;
+        return job;
+    }
+};
+
+struct JobSystem {
+    std::vector<std::thread>       threads;
+    std::unique_ptr<WorkerQueue[]> queues;      // [0] belongs to the calling thread
+    int                            threadCount = 1;
+    std::atomic<bool>              running{ false };
+    std::atomic<int>               queued{ 0 };
+    std::mutex                     sleepMutex;
+    std::condition_variable        wake;
+};
+
+static JobSystem jobs;
+thread_local int jobThreadIndex = 0;
+
+// -----------------------------------------------------------------------------
+// Scheduling
+// -----------------------------------------------------------------------------
+static bool PopOrSteal(int self, Job& out) {
+    {
+        WorkerQueue& own = jobs.queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.count > 0) {
+            out = own.PopBack();
+            jobs.queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (int k = 1; k < jobs.threadCount; ++k) {
+        WorkerQueue& victim = jobs.queues[(self + k) % jobs.threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.count > 0) {
+            out = victim.PopFront();
+            jobs.queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void RunJob(const Job& job) {
+    job.fn(job.ctx, job.begin, job.end, jobThreadIndex);
+    job.pending->fetch_sub(1, std::memory_order_release);
+}
+
+static void WorkerLoop(int index) {
+    jobThreadIndex = index;
+    while (jobs.running.load(std::memory_order_acquire)) {
+        Job job;
+        if (PopOrSteal(index, job)) {
+            RunJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(jobs.sleepMutex);
+        jobs.wake.wait(lock, [] {
+            return !jobs.running.load(std::memory_order_acquire) ||
+                   jobs.queued.load(std::memory_order_relaxed) > 0;
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Lifecycle
+// -----------------------------------------------------------------------------
+void JobsInit(int threadCount) {
+    if (jobs.running) return;
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+
+    jobs.threadCount = threadCount;
+    jobs.queues.reset(new WorkerQueue[threadCount]);
+    jobThreadIndex = 0;
+    if (threadCount == 1) return;
+
+    jobs.running = true;
+    for (int i = 1; i < threadCount; ++i)
+        jobs.threads.emplace_back(WorkerLoop, i);
+}
+
+void JobsShutdown() {
+    if (jobs.running) {
+        {
+            std::lock_guard<std::mutex> lock(jobs.sleepMutex);
+            jobs.running = false;
+        }
+        jobs.wake.notify_all();
+        for (auto& t : jobs.threads) t.join();
+    }
+    jobs.threads.clear();
+    jobs.queues.reset();
+    jobs.threadCount = 1;
+}
+
+int JobsThreadCount() {
+    return jobs.threadCount;
+}
+
+void ParallelFor(size_t count, size_t grain, JobFn fn, void* ctx) {
+    if (count == 0) return;
+    grain = std::max<size_t>(1, grain);
+
+    // Not worth a round trip through the queues, or no workers to share with
+    if (!jobs.running || count <= grain) {
+        fn(ctx, 0, count, jobThreadIndex);
+        return;
+    }
+
+    const size_t chunks = (count + grain - 1) / grain;
+    std::atomic<int> pending{ (int)chunks };
+
+    // Deal chunks round-robin so every queue starts with local work
+    for (size_t c = 0; c < chunks; ++c) {
+        const Job job = { fn, ctx, c * grain, std::min(count, (c + 1) * grain), &pending };
+        WorkerQueue& q = jobs.queues[c % jobs.threadCount];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.PushBack(job);
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobs.sleepMutex);
+        jobs.queued.fetch_add((int)chunks, std::memory_order_relaxed);
+    }
+    jobs.wake.notify_all();
+
+    // The caller works (and steals) until its own batch is done
+    while (pending.load(std::memory_order_acquire) > 0) {
+        Job job;
+        if (PopOrSteal(jobThreadIndex, job))
+            RunJob(job);
+        else
+            std::this_thread::yield();
+    }
+}
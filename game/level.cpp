@@ -0,0 +1,279 @@
+#include "level.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+    #undef near
+    #undef far
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<Platform>::value, "Platform records are mapped in place");
+static_assert(alignof(Platform) <= 16, "compiled level sections are 16-byte aligned");
+
+constexpr uint64_t levelSectionAlign = 16;
+
+// -----------------------------------------------------------------------------
+// File mapping
+// -----------------------------------------------------------------------------
+#if defined(_WIN32)
+bool MapFile(const char* path, MappedFile& file) {
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fh, &size) || size.QuadPart == 0) {
+        CloseHandle(fh);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fh);   // the mapping keeps the file open
+    if (!mapping) return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    file.data   = (const uint8_t*)view;
+    file.size   = (size_t)size.QuadPart;
+    file.handle = mapping;
+    return true;
+}
+
+void UnmapFile(MappedFile& file) {
+    if (file.data) UnmapViewOfFile(file.data);
+    if (file.handle) CloseHandle((HANDLE)file.handle);
+    file = {};
+}
+#else
+bool MapFile(const char* path, MappedFile& file) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // the mapping keeps the file open
+    if (view == MAP_FAILED) return false;
+
+    file.data   = (const uint8_t*)view;
+    file.size   = (size_t)st.st_size;
+    file.handle = nullptr;
+    return true;
+}
+
+void UnmapFile(MappedFile& file) {
+    if (file.data) munmap((void*)file.data, file.size);
+    file = {};
+}
+#endif
+
+void ReleaseLevel(Level& level) {
+    UnmapFile(level.file);
+    level.ownedPlatforms.clear();
+    level.ownedPlatforms.shrink_to_fit();
+}
+
+// -----------------------------------------------------------------------------
+// Text format
+// -----------------------------------------------------------------------------
+bool ParseLevelText(const char* path, std::vector<Platform>& platforms) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    std::vector<Platform> parsed;
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file)) {
+        ++lineNumber;
+        if (char* comment = strchr(line, '#')) *comment = '\0';
+
+        char keyword[32] = {};
+        if (sscanf(line, "%31s", keyword) != 1) continue;   // blank line
+
+        if (strcmp(keyword, "platform") != 0) {
+            TraceLog(LOG_WARNING, "LEVEL: %s:%d: unknown record '%s'", path, lineNumber, keyword);
+            ok = false;
+            break;
+        }
+
+        Platform p;
+        int r = 0, g = 0, b = 0, a = 255;
+        const int fields = sscanf(line, "%*s %f %f %f %f %f %f %d %d %d %d",
+                                  &p.position.x, &p.position.y, &p.position.z,
+                                  &p.size.x, &p.size.y, &p.size.z, &r, &g, &b, &a);
+        if (fields < 9 || p.size.x <= 0.0f || p.size.y <= 0.0f || p.size.z <= 0.0f) {
+            TraceLog(LOG_WARNING, "LEVEL: %s:%d: malformed platform", path, lineNumber);
+            ok = false;
+            break;
+        }
+        p.colour = { (unsigned char)r, (unsigned char)g, (unsigned char)b, (unsigned char)a };
+        parsed.push_back(p);
+    }
+    fclose(file);
+
+    if (!ok || parsed.empty()) return false;
+    platforms = std::move(parsed);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Compiled format
+// -----------------------------------------------------------------------------
+static uint64_t AlignSection(uint64_t offset) {
+    return (offset + levelSectionAlign - 1) & ~(levelSectionAlign - 1);
+}
+
+bool IsCompiledLevel(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    char magic[4] = {};
+    const bool compiled = fread(magic, 1, 4, file) == 4 && memcmp(magic, levelFileMagic, 4) == 0;
+    fclose(file);
+    return compiled;
+}
+
+bool WriteCompiledLevel(const char* path, const Platform* platforms, size_t count) {
+    if (count == 0) return false;
+
+    PlatformGrid grid;
+    BuildPlatformGrid(grid, platforms, count);
+    const size_t cellCount = (size_t)grid.cellsX * grid.cellsZ;
+
+    LevelFileHeader h = {};
+    memcpy(h.magic, levelFileMagic, 4);
+    h.version            = levelFileVersion;
+    h.platformCount      = (uint32_t)count;
+    h.platformStride     = (uint32_t)sizeof(Platform);
+    h.gridOriginX        = grid.originX;
+    h.gridOriginZ        = grid.originZ;
+    h.gridCellSize       = grid.cellSize;
+    h.gridCellsX         = grid.cellsX;
+    h.gridCellsZ         = grid.cellsZ;
+    h.gridCellItemCount  = grid.cellItemCount;
+    h.gridLargeItemCount = grid.largeItemCount;
+
+    struct Section { uint64_t* offset; const void* data; size_t bytes; };
+    const Section sections[] = {
+        { &h.platformsOffset,    platforms,         count * sizeof(Platform) },
+        { &h.cellStartOffset,    grid.cellStart,    (cellCount + 1) * sizeof(uint32_t) },
+        { &h.cellItemsOffset,    grid.cellItems,    grid.cellItemCount * sizeof(uint32_t) },
+        { &h.itemCellMinXOffset, grid.itemCellMinX, count * sizeof(int32_t) },
+        { &h.itemCellMinZOffset, grid.itemCellMinZ, count * sizeof(int32_t) },
+        { &h.largeItemsOffset,   grid.largeItems,   grid.largeItemCount * sizeof(uint32_t) },
+    };
+
+    uint64_t offset = AlignSection(sizeof(LevelFileHeader));
+    for (const Section& s : sections) {
+        *s.offset = offset;
+        offset = AlignSection(offset + s.bytes);
+    }
+    h.fileSize = offset;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    static const uint8_t padding[levelSectionAlign] = {};
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1;
+    uint64_t written = sizeof(h);
+    for (const Section& s : sections) {
+        if (!ok) break;
+        ok = fwrite(padding, 1, (size_t)(*s.offset - written), file) == *s.offset - written;
+        if (ok && s.bytes > 0) ok = fwrite(s.data, 1, s.bytes, file) == s.bytes;
+        written = *s.offset + s.bytes;
+    }
+    if (ok) ok = fwrite(padding, 1, (size_t)(h.fileSize - written), file) == h.fileSize - written;
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+static bool SectionFits(const LevelFileHeader& h, uint64_t offset, uint64_t bytes) {
+    return offset % levelSectionAlign == 0 && offset <= h.fileSize && bytes <= h.fileSize - offset;
+}
+
+bool MapCompiledLevel(const char* path, Level& level, PlatformList& platforms, PlatformGrid& grid) {
+    MappedFile file;
+    if (!MapFile(path, file)) return false;
+
+    LevelFileHeader h;
+    bool ok = file.size >= sizeof(h);
+    if (ok) {
+        memcpy(&h, file.data, sizeof(h));
+        const uint64_t cellCount = (uint64_t)std::max(0, h.gridCellsX) * (uint64_t)std::max(0, h.gridCellsZ);
+        ok = memcmp(h.magic, levelFileMagic, 4) == 0 &&
+             h.version == levelFileVersion &&
+             h.platformStride == sizeof(Platform) &&
+             h.platformCount > 0 &&
+             h.fileSize == file.size &&
+             h.gridCellsX > 0 && h.gridCellsZ > 0 && h.gridCellSize > 0.0f &&
+             SectionFits(h, h.platformsOffset,    (uint64_t)h.platformCount * sizeof(Platform)) &&
+             SectionFits(h, h.cellStartOffset,    (cellCount + 1) * sizeof(uint32_t)) &&
+             SectionFits(h, h.cellItemsOffset,    (uint64_t)h.gridCellItemCount * sizeof(uint32_t)) &&
+             SectionFits(h, h.itemCellMinXOffset, (uint64_t)h.platformCount * sizeof(int32_t)) &&
+             SectionFits(h, h.itemCellMinZOffset, (uint64_t)h.platformCount * sizeof(int32_t)) &&
+             SectionFits(h, h.largeItemsOffset,   (uint64_t)h.gridLargeItemCount * sizeof(uint32_t));
+    }
+    if (ok) {
+        // One linear pass over the index so a damaged file can't send queries
+        // out of bounds; still no allocation and no per-record decoding
+        const uint32_t* cellStart = (const uint32_t*)(file.data + h.cellStartOffset);
+        const uint32_t* cellItems = (const uint32_t*)(file.data + h.cellItemsOffset);
+        const uint32_t* largeItems = (const uint32_t*)(file.data + h.largeItemsOffset);
+        const size_t cellCount = (size_t)h.gridCellsX * h.gridCellsZ;
+        ok = cellStart[0] == 0 && cellStart[cellCount] == h.gridCellItemCount;
+        for (size_t c = 0; ok && c < cellCount; ++c)
+            ok = cellStart[c] <= cellStart[c + 1];
+        for (uint32_t i = 0; ok && i < h.gridCellItemCount; ++i)
+            ok = cellItems[i] < h.platformCount;
+        for (uint32_t i = 0; ok && i < h.gridLargeItemCount; ++i)
+            ok = largeItems[i] < h.platformCount;
+    }
+    if (!ok) {
+        TraceLog(LOG_WARNING, "LEVEL: %s is not a compatible compiled level", path);
+        UnmapFile(file);
+        return false;
+    }
+
+    // Only now let go of whatever the world was using
+    ReleaseLevel(level);
+    level.file = file;
+
+    platforms.items = (const Platform*)(file.data + h.platformsOffset);
+    platforms.count = h.platformCount;
+
+    grid.cellStartData.clear();
+    grid.cellItemsData.clear();
+    grid.itemCellMinXData.clear();
+    grid.itemCellMinZData.clear();
+    grid.largeItemsData.clear();
+    grid.originX        = h.gridOriginX;
+    grid.originZ        = h.gridOriginZ;
+    grid.cellSize       = h.gridCellSize;
+    grid.invCellSize    = 1.0f / h.gridCellSize;
+    grid.cellsX         = h.gridCellsX;
+    grid.cellsZ         = h.gridCellsZ;
+    grid.cellStart      = (const uint32_t*)(file.data + h.cellStartOffset);
+    grid.cellItems      = (const uint32_t*)(file.data + h.cellItemsOffset);
+    grid.itemCellMinX   = (const int32_t*)(file.data + h.itemCellMinXOffset);
+    grid.itemCellMinZ   = (const int32_t*)(file.data + h.itemCellMinZOffset);
+    grid.largeItems     = (const uint32_t*)(file.data + h.largeItemsOffset);
+    grid.cellItemCount  = h.gridCellItemCount;
+    grid.largeItemCount = h.gridLargeItemCount;
+    return true;
+}
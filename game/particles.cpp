@@ -0,0 +1,265 @@
+#include "particles.h"
+#include "arena.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Shaders
+// -----------------------------------------------------------------------------
+// One instance per particle. The emit attributes advance once every
+// particlesPerEmit instances, so instance i belongs to record i / particlesPerEmit
+// and is particle i % particlesPerEmit of it; that index and the record's seed
+// pick its direction and speed. Expired particles collapse to a point.
+static const char* particleVS = R"(#version 330
+layout(location = 0) in vec2 corner;       // quad corner in [-1, 1]
+layout(location = 1) in vec4 emitOrigin;   // position, emit time
+layout(location = 2) in vec2 emitParams;   // kind, seed
+
+uniform mat4  mvp;
+uniform vec3  cameraRight;
+uniform vec3  cameraUp;
+uniform float time;
+uniform float lifetime[2];
+uniform int   particlesPerEmit;
+
+out vec2 fragCorner;
+out vec4 fragColor;
+
+const float speed[2]   = float[2](6.0, 4.0);
+const float size[2]    = float[2](0.035, 0.08);
+const float gravity[2] = float[2](4.0, 9.81);
+const vec3  colorStart[2] = vec3[2](vec3(1.0, 0.95, 0.6), vec3(0.9, 0.3, 1.0));
+const vec3  colorEnd[2]   = vec3[2](vec3(1.0, 0.4, 0.1), vec3(0.6, 0.05, 0.1));
+
+uint Hash(uint x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float Random(inout uint state) {
+    state = Hash(state);
+    return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+void main() {
+    int   kind = int(emitParams.x);
+    float age  = time - emitOrigin.w;
+    fragCorner = corner;
+    if (age < 0.0 || age >= lifetime[kind]) {
+        fragColor   = vec4(0.0);
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    uint state = Hash(uint(emitParams.y) * uint(particlesPerEmit) + uint(gl_InstanceID % particlesPerEmit));
+    float z = Random(state) * 2.0 - 1.0;
+    float a = Random(state) * 6.2831853;
+    vec3 dir = vec3(sqrt(1.0 - z * z) * cos(a), z, sqrt(1.0 - z * z) * sin(a));
+    if (kind == 1) dir.y = abs(dir.y);   // bursts fountain up from the body
+    float v = speed[kind] * (0.4 + 0.6 * Random(state));
+
+    vec3 pos = emitOrigin.xyz + dir * (v * age) - vec3(0.0, 0.5 * gravity[kind] * age * age, 0.0);
+    float t = age / lifetime[kind];
+    float s = size[kind] * (1.0 - t);
+    fragColor   = vec4(mix(colorStart[kind], colorEnd[kind], t), 1.0 - t);
+    gl_Position = mvp * vec4(pos + (cameraRight * corner.x + cameraUp * corner.y) * s, 1.0);
+}
+)";
+
+static const char* particleFS = R"(#version 330
+in vec2 fragCorner;
+in vec4 fragColor;
+out vec4 finalColor;
+
+void main() {
+    float d = dot(fragCorner, fragCorner);
+    if (d > 1.0) discard;
+    finalColor = vec4(fragColor.rgb, fragColor.a * (1.0 - d));
+}
+)";
+
+// -----------------------------------------------------------------------------
+// State
+// -----------------------------------------------------------------------------
+struct GpuEmit {
+    float x, y, z, time;
+    float kind, seed;
+};
+
+struct ParticleSystem {
+    std::atomic<bool> active;
+    std::mutex mutex;                    // guards pending and dropped
+    std::vector<ParticleEmit> pending;   // queued since the last draw
+    uint64_t   dropped;
+
+    std::vector<ParticleEmit> draining;  // main thread; swapped with pending
+    Shader       shader;
+    int          mvpLoc, rightLoc, upLoc, timeLoc;
+    unsigned int vao;
+    unsigned int cornerVbo;
+    unsigned int emitVbo;
+    int          head;                   // next ring record to write
+    int          resident;
+    uint32_t     seed;
+    double       lastEmitTime;
+    uint64_t     emitted;
+    int          instances;
+};
+
+static ParticleSystem particles;
+
+// -----------------------------------------------------------------------------
+// Lifecycle
+// -----------------------------------------------------------------------------
+void InitParticles() {
+    particles.shader = LoadShaderFromMemory(particleVS, particleFS);
+    if (!IsShaderValid(particles.shader)) {
+        TraceLog(LOG_WARNING, "PARTICLES: Shader unavailable, particles are off");
+        return;
+    }
+    Shader& shader = particles.shader;
+    particles.mvpLoc   = GetShaderLocation(shader, "mvp");
+    particles.rightLoc = GetShaderLocation(shader, "cameraRight");
+    particles.upLoc    = GetShaderLocation(shader, "cameraUp");
+    particles.timeLoc  = GetShaderLocation(shader, "time");
+    const int perEmit  = particlesPerEmit;
+    SetShaderValueV(shader, GetShaderLocation(shader, "lifetime"), particleLifetime,
+                    SHADER_UNIFORM_FLOAT, PARTICLE_KIND_COUNT);
+    SetShaderValue(shader, GetShaderLocation(shader, "particlesPerEmit"), &perEmit, SHADER_UNIFORM_INT);
+
+    // Two triangles per particle, then the emit ring; unused records are
+    // stamped long ago, so they are past any lifetime and draw nothing
+    static const float corners[] = { -1, -1,  1, -1,  1, 1,  -1, -1,  1, 1,  -1, 1 };
+    std::vector<GpuEmit> empty(particleEmitCapacity, GpuEmit{ 0, 0, 0, -1e9f, 0, 0 });
+    particles.vao = rlLoadVertexArray();
+    rlEnableVertexArray(particles.vao);
+    particles.cornerVbo = rlLoadVertexBuffer(corners, sizeof(corners), false);
+    rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(0);
+    particles.emitVbo = rlLoadVertexBuffer(empty.data(), (int)(empty.size() * sizeof(GpuEmit)), true);
+    rlSetVertexAttribute(1, 4, RL_FLOAT, false, sizeof(GpuEmit), 0);
+    rlEnableVertexAttribute(1);
+    rlSetVertexAttributeDivisor(1, particlesPerEmit);
+    rlSetVertexAttribute(2, 2, RL_FLOAT, false, sizeof(GpuEmit), offsetof(GpuEmit, kind));
+    rlEnableVertexAttribute(2);
+    rlSetVertexAttributeDivisor(2, particlesPerEmit);
+    rlDisableVertexArray();
+
+    // Both queues hold a full ring, so queuing never allocates
+    particles.pending.reserve(particleEmitCapacity);
+    particles.draining.reserve(particleEmitCapacity);
+    particles.head = particles.resident = 0;
+    particles.lastEmitTime = -1e9;
+    particles.active = true;
+}
+
+void ShutdownParticles() {
+    if (!particles.active) return;
+    {
+        std::lock_guard<std::mutex> lock(particles.mutex);
+        particles.active = false;
+        particles.pending.clear();
+    }
+    rlUnloadVertexArray(particles.vao);
+    rlUnloadVertexBuffer(particles.cornerVbo);
+    rlUnloadVertexBuffer(particles.emitVbo);
+    UnloadShader(particles.shader);
+    particles.shader = {};
+}
+
+// -----------------------------------------------------------------------------
+// Emitting and drawing
+// -----------------------------------------------------------------------------
+void QueueParticleEmits(const ParticleEmit* emits, size_t count) {
+    if (count == 0 || !particles.active.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(particles.mutex);
+    if (!particles.active) return;
+    const size_t room = particles.pending.capacity() - particles.pending.size();
+    const size_t taken = std::min(count, room);
+    particles.pending.insert(particles.pending.end(), emits, emits + taken);
+    particles.dropped += count - taken;
+}
+
+// Writes the drained emits into the ring, stamped with the render clock, in at
+// most two spans (the second after wrapping)
+static void UploadEmits(double now) {
+    std::vector<ParticleEmit>& emits = particles.draining;
+    if (emits.empty()) return;
+    FrameVector<GpuEmit> records;
+    records.reserve(emits.size());
+    for (const ParticleEmit& e : emits) {
+        particles.seed = (particles.seed + 1) & 0xFFFFFFu;   // exact as a float
+        records.push_back({ e.position.x, e.position.y, e.position.z, (float)now,
+                            (float)e.kind, (float)particles.seed });
+    }
+
+    const int count = (int)records.size();
+    int written = 0;
+    while (written < count) {
+        const int span = std::min(count - written, particleEmitCapacity - particles.head);
+        rlUpdateVertexBuffer(particles.emitVbo, records.data() + written, span * (int)sizeof(GpuEmit),
+                             particles.head * (int)sizeof(GpuEmit));
+        particles.head = (particles.head + span) % particleEmitCapacity;
+        written += span;
+    }
+    particles.resident = std::min(particles.resident + count, particleEmitCapacity);
+    particles.emitted += (uint64_t)count;
+    particles.lastEmitTime = now;
+    emits.clear();
+}
+
+void DrawParticles() {
+    particles.instances = 0;
+    if (!particles.active) return;
+    {
+        std::lock_guard<std::mutex> lock(particles.mutex);
+        particles.pending.swap(particles.draining);
+    }
+    const double now = GetTime();
+    UploadEmits(now);
+
+    // Every record has expired: the whole ring would collapse in the shader
+    const float longest = *std::max_element(std::begin(particleLifetime), std::end(particleLifetime));
+    if (particles.resident == 0 || now - particles.lastEmitTime > longest) return;
+
+    const Matrix view = rlGetMatrixModelview();
+    const Matrix mvp  = MatrixMultiply(view, rlGetMatrixProjection());
+    const Vector3 right = { view.m0, view.m4, view.m8 };
+    const Vector3 up    = { view.m1, view.m5, view.m9 };
+    const float time    = (float)now;
+
+    // Additive and without depth writes, so overlapping sparks needn't be sorted
+    BeginBlendMode(BLEND_ADDITIVE);
+    rlEnableShader(particles.shader.id);
+    rlSetUniformMatrix(particles.mvpLoc, mvp);
+    rlSetUniform(particles.rightLoc, &right, RL_SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(particles.upLoc, &up, RL_SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(particles.timeLoc, &time, RL_SHADER_UNIFORM_FLOAT, 1);
+    rlDisableDepthMask();
+
+    particles.instances = particles.resident * particlesPerEmit;
+    rlEnableVertexArray(particles.vao);
+    rlDrawVertexArrayInstanced(0, 6, particles.instances);
+    rlDisableVertexArray();
+
+    rlEnableDepthMask();
+    rlDisableShader();
+    EndBlendMode();
+}
+
+ParticleStats GetParticleStats() {
+    ParticleStats stats = {};
+    stats.resident  = particles.resident;
+    stats.instances = particles.instances;
+    stats.emitted   = particles.emitted;
+    std::lock_guard<std::mutex> lock(particles.mutex);
+    stats.dropped = particles.dropped;
+    return stats;
+}
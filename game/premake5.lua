@@ -17,6 +17,18 @@
 
 baseName = path.getbasename(os.getcwd());
 
+newoption
+{
+    trigger = "simd-avx",
+    description = "Compile the game's SIMD kernels for AVX2 instead of the SSE2 baseline"
+}
+
+-- Telemetry's UDP sink, for every project below; MSVC also gets this from a
+-- pragma, MinGW doesn't
+filter "system:windows"
+    links {"ws2_32"}
+filter{}
+
 project (workspaceName)
     kind "ConsoleApp"
     location "./"
@@ -38,6 +50,7 @@ project (workspaceName)
         ["Application Resource Files/*"] = {"src/**.rc", "src/**.ico"},
     }
     files {"**.c", "**.cpp", "**.h", "**.hpp"}
+    removefiles {"tools/**"}
 
     filter "system:windows"
         files {"src/**.rc", "src/**.ico"}
@@ -49,6 +62,10 @@ project (workspaceName)
 		
     filter{}
 
+    filter "options:simd-avx"
+        vectorextensions "AVX2"
+    filter{}
+
   
     includedirs { "./" }
     includedirs { "src" }
@@ -56,4 +73,57 @@ project (workspaceName)
     
     link_raylib()
     link_to("staticLib")
--- To link to a lib use link_to("LIB_FOLDER_NAME")
\ No newline at end of file
+-- To link to a lib use link_to("LIB_FOLDER_NAME")
+
+-- Headless simulation runner: fixed-dt ticks from scripted input, no window or
+-- draw calls. Shares every game source except the windowed entry point.
+project (workspaceName .. "-headless")
+    kind "ConsoleApp"
+    location "./"
+    targetdir "../bin/%{cfg.buildcfg}"
+
+    vpaths 
+    {
+        ["Header Files/*"] = { "include/**.h",  "include/**.hpp", "**.h", "**.hpp"},
+        ["Source Files/*"] = { "**.c", "**.cpp"},
+    }
+    files {"**.c", "**.cpp", "**.h", "**.hpp"}
+    removefiles {"src/**", "tools/**"}
+    files {"tools/headless.cpp", "tools/benchlevel.h"}
+
+    -- Keep the phase timers in Release so the benchmark can report them
+    defines {"LIX_PROFILER"}
+
+    filter "options:simd-avx"
+        vectorextensions "AVX2"
+    filter{}
+
+    includedirs { "./" }
+    includedirs { "include" }
+
+    link_raylib()
+
+-- Microbenchmarks for the collision and update hot paths. Prints a table, and
+-- with --json writes results that can be compared between commits.
+project (workspaceName .. "-microbench")
+    kind "ConsoleApp"
+    location "./"
+    targetdir "../bin/%{cfg.buildcfg}"
+
+    vpaths 
+    {
+        ["Header Files/*"] = { "include/**.h",  "include/**.hpp", "**.h", "**.hpp"},
+        ["Source Files/*"] = { "**.c", "**.cpp"},
+    }
+    files {"**.c", "**.cpp", "**.h", "**.hpp"}
+    removefiles {"src/**", "tools/**"}
+    files {"tools/microbench.cpp", "tools/benchlevel.h"}
+
+    filter "options:simd-avx"
+        vectorextensions "AVX2"
+    filter{}
+
+    includedirs { "./" }
+    includedirs { "include" }
+
+    link_raylib()
@@ -0,0 +1,141 @@
+#include "profiler.h"
+
+#if LIX_PROFILING
+#include "raylib.h"
+#include "arena.h"
+#include <algorithm>
+
+Profiler profiler;
+
+static const char* phaseNames[PHASE_COUNT] = {
+    "Input",
+    "Streaming",
+    "Spawn",
+    "Player",
+    "Projectiles",
+    "Compaction",
+    "Enemies",
+    "Events",
+    "Draw world",
+    "Draw HUD",
+};
+
+// -----------------------------------------------------------------------------
+// Recording
+// -----------------------------------------------------------------------------
+void ProfilerBeginFrame() {
+    const auto now = std::chrono::steady_clock::now();
+
+    // The very first call has no open frame to close
+    if (profiler.frameStart.time_since_epoch().count() != 0) {
+        const int row = profiler.head;
+        for (int p = 0; p < PHASE_COUNT; ++p)
+            profiler.phaseMs[row][p] = profiler.currentNs[p].exchange(0, std::memory_order_relaxed) * 1e-6f;
+        profiler.frameMs[row] = std::chrono::duration<float, std::milli>(now - profiler.frameStart).count();
+
+        profiler.head = (profiler.head + 1) % profilerHistory;
+        if (profiler.frames < profilerHistory) profiler.frames++;
+    }
+
+    profiler.frameStart = now;
+}
+
+static thread_local float threadPhaseMs[PHASE_COUNT];
+
+void ProfilerAddSample(ProfilePhase phase, float ms) {
+    profiler.currentNs[phase].fetch_add((uint64_t)(ms * 1e6f), std::memory_order_relaxed);
+    threadPhaseMs[phase] += ms;
+}
+
+void ProfilerTakeThreadTotals(float outMs[PHASE_COUNT]) {
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        outMs[p] = threadPhaseMs[p];
+        threadPhaseMs[p] = 0.0f;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Statistics
+// -----------------------------------------------------------------------------
+static PhaseSummary Summarize(const float* samples, int stride) {
+    const int n = profiler.frames;
+    if (n == 0) return {};
+
+    float sorted[profilerHistory];
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sorted[i] = samples[i * stride];
+        sum += sorted[i];
+    }
+    std::sort(sorted, sorted + n);
+
+    const int p99 = std::min(n - 1, (int)(n * 0.99f));
+    return { sum / n, sorted[p99], sorted[n - 1] };
+}
+
+PhaseSummary ProfilerSummarize(ProfilePhase phase) {
+    return Summarize(&profiler.phaseMs[0][phase], PHASE_COUNT);
+}
+
+PhaseSummary ProfilerSummarizeFrame() {
+    return Summarize(profiler.frameMs, 1);
+}
+
+const char* ProfilerPhaseName(ProfilePhase phase) {
+    return phaseNames[phase];
+}
+
+// -----------------------------------------------------------------------------
+// Overlay
+// -----------------------------------------------------------------------------
+void ProfilerToggleOverlay() {
+    profiler.overlayVisible = !profiler.overlayVisible;
+}
+
+bool ProfilerOverlayVisible() {
+    return profiler.overlayVisible;
+}
+
+void DrawProfilerOverlay(int x, int y) {
+    if (!profiler.overlayVisible) return;
+
+    constexpr int width      = 330;
+    constexpr int rowHeight  = 14;
+    constexpr int graphH     = 60;
+    constexpr float graphMaxMs = 33.3f;
+    const int height = 24 + (PHASE_COUNT + 1) * rowHeight + graphH + 12;
+
+    DrawRectangle(x, y, width, height, { 0, 0, 0, 170 });
+    DrawText("phase            avg    p99    max (ms)", x + 6, y + 6, 10, RAYWHITE);
+
+    int rowY = y + 22;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        const PhaseSummary s = ProfilerSummarize((ProfilePhase)p);
+        DrawText(phaseNames[p], x + 6, rowY, 10, LIGHTGRAY);
+        DrawText(FrameFormat("%6.3f %6.3f %6.3f", s.avgMs, s.p99Ms, s.maxMs), x + 130, rowY, 10, LIGHTGRAY);
+        rowY += rowHeight;
+    }
+    const PhaseSummary frame = ProfilerSummarizeFrame();
+    DrawText("Frame", x + 6, rowY, 10, YELLOW);
+    DrawText(FrameFormat("%6.3f %6.3f %6.3f", frame.avgMs, frame.p99Ms, frame.maxMs), x + 130, rowY, 10, YELLOW);
+    rowY += rowHeight + 4;
+
+    // Frame-time graph, oldest on the left; the line marks 16.7 ms
+    const int graphW = width - 12;
+    const int gx = x + 6;
+    const int gy = rowY;
+    DrawRectangleLines(gx, gy, graphW, graphH, GRAY);
+    const int budgetY = gy + graphH - (int)(graphH * 16.7f / graphMaxMs);
+    DrawLine(gx, budgetY, gx + graphW, budgetY, GREEN);
+
+    const int n = profiler.frames;
+    for (int i = 0; i < n; ++i) {
+        const int row = (profiler.head - n + i + profilerHistory) % profilerHistory;
+        const float ms = std::min(profiler.frameMs[row], graphMaxMs);
+        const int h = (int)(graphH * ms / graphMaxMs);
+        const int px = gx + (i * graphW) / profilerHistory;
+        DrawLine(px, gy + graphH, px, gy + graphH - h, (ms > 16.7f) ? RED : SKYBLUE);
+    }
+}
+
+#endif
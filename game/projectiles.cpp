@@ -0,0 +1,90 @@
+#include "projectiles.h"
+#include "simd.h"
+
+// -----------------------------------------------------------------------------
+// Projectile pool
+// -----------------------------------------------------------------------------
+void InitProjectilePool(ProjectilePool& pool, size_t capacity, float radius) {
+    pool.radius = radius;
+    pool.count  = 0;
+    if (pool.capacity == capacity) {
+        ClearHandleTable(pool.handles);
+        return;
+    }
+
+    pool.capacity = capacity;
+    InitHandleTable(pool.handles, (uint32_t)capacity);
+    for (auto* field : { &pool.posX, &pool.posY, &pool.posZ,
+                         &pool.prevX, &pool.prevY, &pool.prevZ,
+                         &pool.velX, &pool.velY, &pool.velZ,
+                         &pool.lifetime }) {
+        field->assign(capacity, 0.0f);
+    }
+}
+
+void ClearProjectiles(ProjectilePool& pool) {
+    ClearHandleTable(pool.handles);
+    pool.count = 0;
+}
+
+EntityHandle SpawnProjectile(ProjectilePool& pool, const Vector3& pos, const Vector3& vel, float lifetime) {
+    const EntityHandle h = AcquireHandle(pool.handles);
+    if (h.generation == 0) return nullEntity;
+
+    const size_t i = pool.count++;
+    pool.posX[i]  = pos.x; pool.posY[i]  = pos.y; pool.posZ[i]  = pos.z;
+    pool.prevX[i] = pos.x; pool.prevY[i] = pos.y; pool.prevZ[i] = pos.z;
+    pool.velX[i]  = vel.x; pool.velY[i]  = vel.y; pool.velZ[i]  = vel.z;
+    pool.lifetime[i] = lifetime;
+    return h;
+}
+
+void IntegrateProjectiles(ProjectilePool& pool, float dt) {
+    const size_t n = pool.count;
+    size_t i = 0;
+
+    const simd::f32 vdt = simd::set1(dt);
+    for (; i + simd::width <= n; i += simd::width) {
+        const simd::f32 px = simd::load(&pool.posX[i]);
+        const simd::f32 py = simd::load(&pool.posY[i]);
+        const simd::f32 pz = simd::load(&pool.posZ[i]);
+        simd::store(&pool.prevX[i], px);
+        simd::store(&pool.prevY[i], py);
+        simd::store(&pool.prevZ[i], pz);
+        simd::store(&pool.posX[i], simd::add(px, simd::mul(simd::load(&pool.velX[i]), vdt)));
+        simd::store(&pool.posY[i], simd::add(py, simd::mul(simd::load(&pool.velY[i]), vdt)));
+        simd::store(&pool.posZ[i], simd::add(pz, simd::mul(simd::load(&pool.velZ[i]), vdt)));
+        simd::store(&pool.lifetime[i], simd::sub(simd::load(&pool.lifetime[i]), vdt));
+    }
+
+    // Scalar tail
+    for (; i < n; ++i) {
+        pool.prevX[i] = pool.posX[i];
+        pool.prevY[i] = pool.posY[i];
+        pool.prevZ[i] = pool.posZ[i];
+        pool.posX[i] += pool.velX[i] * dt;
+        pool.posY[i] += pool.velY[i] * dt;
+        pool.posZ[i] += pool.velZ[i] * dt;
+        pool.lifetime[i] -= dt;
+    }
+}
+
+void RemoveProjectile(ProjectilePool& pool, size_t index) {
+    ReleaseDense(pool.handles, (uint32_t)index);
+    const size_t last = --pool.count;
+    if (index == last) return;
+
+    pool.posX[index]  = pool.posX[last];  pool.posY[index]  = pool.posY[last];  pool.posZ[index]  = pool.posZ[last];
+    pool.prevX[index] = pool.prevX[last]; pool.prevY[index] = pool.prevY[last]; pool.prevZ[index] = pool.prevZ[last];
+    pool.velX[index]  = pool.velX[last];  pool.velY[index]  = pool.velY[last];  pool.velZ[index]  = pool.velZ[last];
+    pool.lifetime[index] = pool.lifetime[last];
+}
+
+void RemoveDeadProjectiles(ProjectilePool& pool) {
+    for (size_t i = 0; i < pool.count;) {
+        if (pool.lifetime[i] <= 0.0f)
+            RemoveProjectile(pool, i);   // re-test the projectile swapped into i
+        else
+            ++i;
+    }
+}
@@ -0,0 +1,302 @@
+#include "render.h"
+#include "snapshot.h"
+#include "frustum.h"
+#include "arena.h"
+#include "rlgl.h"
+
+Renderer renderer = {};
+
+// -----------------------------------------------------------------------------
+// Shaders
+// -----------------------------------------------------------------------------
+static const char* instancedVS = R"(#version 330
+in vec3 vertexPosition;
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+
+out vec4 fragColor;
+
+void main() {
+    // Bottom row of an affine transform is (0,0,0,1); the renderer stores the tint there
+    fragColor = vec4(instanceTransform[0][3], instanceTransform[1][3],
+                     instanceTransform[2][3], instanceTransform[3][3]);
+    mat4 model = instanceTransform;
+    model[0][3] = 0.0;
+    model[1][3] = 0.0;
+    model[2][3] = 0.0;
+    model[3][3] = 1.0;
+    gl_Position = mvp * model * vec4(vertexPosition, 1.0);
+}
+)";
+
+static const char* instancedFS = R"(#version 330
+in vec4 fragColor;
+out vec4 finalColor;
+
+void main() {
+    finalColor = fragColor;
+}
+)";
+
+// Impostors: the unit XZ plane becomes an upright quad facing the camera. It
+// turns about the vertical axis only, so sprites stay standing when seen from
+// above. Size and centre come from the packed instance matrix.
+static const char* impostorVS = R"(#version 330
+in vec3 vertexPosition;
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+uniform vec3 billboardRight;
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main() {
+    fragColor = vec4(instanceTransform[0][3], instanceTransform[1][3],
+                     instanceTransform[2][3], instanceTransform[3][3]);
+    vec2 corner = vec2(vertexPosition.x, -vertexPosition.z);
+    fragTexCoord = vec2(corner.x + 0.5, 0.5 - corner.y);
+    vec3 world = instanceTransform[3].xyz
+               + billboardRight * (corner.x * instanceTransform[0][0])
+               + vec3(0.0, corner.y * instanceTransform[1][1], 0.0);
+    gl_Position = mvp * vec4(world, 1.0);
+}
+)";
+
+static const char* impostorFS = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+uniform sampler2D texture0;
+
+out vec4 finalColor;
+
+void main() {
+    vec4 texel = texture(texture0, fragTexCoord);
+    if (texel.a < 0.5) discard;
+    finalColor = texel * fragColor;
+}
+)";
+
+// -----------------------------------------------------------------------------
+// Lifecycle
+// -----------------------------------------------------------------------------
+void InitRenderer() {
+    renderer.cube     = GenMeshCube(1.0f, 1.0f, 1.0f);
+    renderer.material = LoadMaterialDefault();
+    renderer.shader   = LoadShaderFromMemory(instancedVS, instancedFS);
+
+    renderer.instancing = IsShaderValid(renderer.shader);
+    if (renderer.instancing) {
+        renderer.shader.locs[SHADER_LOC_MATRIX_MVP]   = GetShaderLocation(renderer.shader, "mvp");
+        renderer.shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(renderer.shader, "instanceTransform");
+        renderer.material.shader = renderer.shader;
+    } else {
+        TraceLog(LOG_WARNING, "RENDER: Instancing shader unavailable, using immediate mode");
+    }
+
+    // Until the sprite is in (or if it never is), impostors are flat quads in
+    // the mesh tier's colour
+    renderer.quad             = GenMeshPlane(1.0f, 1.0f, 1, 1);
+    renderer.impostorMaterial = LoadMaterialDefault();
+    renderer.impostorSprite   = AcquireTexture(enemyImpostorTexture);
+    if (renderer.instancing) {
+        renderer.impostorShader = LoadShaderFromMemory(impostorVS, impostorFS);
+        renderer.impostors = IsShaderValid(renderer.impostorShader);
+        if (!renderer.impostors)
+            TraceLog(LOG_WARNING, "RENDER: Impostor shader unavailable, drawing impostors in immediate mode");
+    }
+    if (renderer.impostors) {
+        Shader& shader = renderer.impostorShader;
+        shader.locs[SHADER_LOC_MATRIX_MVP]   = GetShaderLocation(shader, "mvp");
+        shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
+        renderer.billboardRightLoc = GetShaderLocation(shader, "billboardRight");
+        renderer.impostorMaterial.shader = shader;
+    }
+
+    renderer.impostorDistance = enemyImpostorDistance;
+    renderer.stats = {};
+}
+
+void ShutdownRenderer() {
+    // The sprite belongs to the asset manager, not the material
+    renderer.impostorMaterial.maps[MATERIAL_MAP_DIFFUSE].texture.id = rlGetTextureIdDefault();
+    ReleaseAsset(renderer.impostorSprite);
+    UnloadMaterial(renderer.material);           // also releases the instancing shader
+    UnloadMaterial(renderer.impostorMaterial);   // and the impostor shader
+    UnloadMesh(renderer.cube);
+    UnloadMesh(renderer.quad);
+    renderer = {};
+}
+
+// -----------------------------------------------------------------------------
+// World pass
+// -----------------------------------------------------------------------------
+static void SubmitInstances(const FrameVector<Matrix>& transforms) {
+    if (transforms.empty()) return;
+    DrawMeshInstanced(renderer.cube, renderer.material, transforms.data(), (int)transforms.size());
+    renderer.stats.drawCalls++;
+}
+
+static void SubmitImpostors(const FrameVector<Matrix>& transforms, const Camera3D& camera) {
+    if (transforms.empty()) return;
+    // Right vector of the camera's heading; quads only turn about the vertical
+    const Vector3 look = Vector3Subtract(camera.target, camera.position);
+    const Vector3 right = Vector3Normalize({ -look.z, 0.0f, look.x });
+    SetShaderValue(renderer.impostorShader, renderer.billboardRightLoc, &right, SHADER_UNIFORM_VEC3);
+
+    // Quads face the camera, so whichever winding they end up with is the front
+    rlDisableBackfaceCulling();
+    DrawMeshInstanced(renderer.quad, renderer.impostorMaterial, transforms.data(), (int)transforms.size());
+    rlEnableBackfaceCulling();
+    renderer.stats.drawCalls++;
+}
+
+// One billboard per impostor, for when the impostor shader isn't available
+static void DrawImpostorsImmediate(const FrameVector<Matrix>& impostors, const Camera3D& camera) {
+    const Texture2D sprite = renderer.impostorMaterial.maps[MATERIAL_MAP_DIFFUSE].texture;
+    for (const Matrix& m : impostors) {
+        const Color c = { (unsigned char)(m.m3 * 255.0f + 0.5f), (unsigned char)(m.m7 * 255.0f + 0.5f),
+                          (unsigned char)(m.m11 * 255.0f + 0.5f), (unsigned char)(m.m15 * 255.0f + 0.5f) };
+        DrawBillboardRec(camera, sprite, { 0.0f, 0.0f, (float)sprite.width, (float)sprite.height },
+                         { m.m12, m.m13, m.m14 }, { m.m0, m.m5 }, c);
+        renderer.stats.drawCalls++;
+    }
+}
+
+// Tier for an enemy distSq away (squared) that was drawn at `current` last
+// frame. Past the impostor distance plus the hysteresis band it drops to an
+// impostor, and only comes back inside the distance minus the band.
+static uint8_t SelectEnemyLod(uint8_t current, float distSq) {
+    const float d = renderer.impostorDistance;
+    if (d <= 0.0f) return ENEMY_LOD_MESH;
+    const float limit = (current == ENEMY_LOD_MESH) ? d * (1.0f + enemyLodHysteresis)
+                                                    : d * (1.0f - enemyLodHysteresis);
+    return distSq > limit * limit ? ENEMY_LOD_IMPOSTOR : ENEMY_LOD_MESH;
+}
+
+// Tier memory is per enemy slot; an enemy seen for the first time (or a new
+// generation in the slot) starts on whichever side of the distance it is
+static uint8_t EnemyLodFor(EntityHandle handle, float distSq) {
+    uint8_t& tier = renderer.enemyLod[handle.slot];
+    uint32_t& generation = renderer.enemyLodGeneration[handle.slot];
+    if (generation != handle.generation) {
+        generation = handle.generation;
+        const float d = renderer.impostorDistance;
+        tier = (d > 0.0f && distSq > d * d) ? ENEMY_LOD_IMPOSTOR : ENEMY_LOD_MESH;
+        return tier;
+    }
+    tier = SelectEnemyLod(tier, distSq);
+    return tier;
+}
+
+void DrawWorldInstanced(const RenderSnapshot& snapshot, const Camera3D& camera, float alpha) {
+    renderer.stats = {};
+    // Platforms are static between level changes; their instance buffer comes
+    // prebuilt with the set
+    const PlatformRenderSet& level = *snapshot.platforms;
+
+    const float aspect  = (float)GetScreenWidth() / (float)std::max(1, GetScreenHeight());
+    const float farClip = (renderer.maxDrawDistance > 0.0f)
+        ? std::min(renderer.maxDrawDistance, renderFarPlane) : renderFarPlane;
+    const Frustum frustum = MakeFrustum(camera, aspect, renderNearPlane, farClip);
+
+    // Platforms: only those in grid cells under the frustum's footprint are tested
+    float minX, minZ, maxX, maxZ;
+    FrustumBoundsXZ(frustum, minX, minZ, maxX, maxZ);
+    // Visible instance lists are per-frame and live in the frame arena, sized for
+    // the worst case so they never regrow
+    FrameVector<Matrix> visiblePlatforms;
+    visiblePlatforms.reserve(level.platforms.size());
+    QueryPlatformGrid(level.grid, minX, minZ, maxX, maxZ,
+        [&](uint32_t i) {
+            const Platform& p = level.platforms[i];
+            const Vector3 half = Vector3Scale(p.size, 0.5f);
+            if (AABBInFrustum(frustum, Vector3Subtract(p.position, half), Vector3Add(p.position, half)))
+                visiblePlatforms.push_back(level.transforms[i]);
+            return false;
+        });
+    renderer.stats.platformInstances = (int)visiblePlatforms.size();
+    renderer.stats.platformsCulled   = (int)level.platforms.size() - renderer.stats.platformInstances;
+
+    // Enemy slots index the per-enemy tier memory, sized with the pool
+    if (renderer.enemyLod.size() < snapshot.debug.enemyCapacity) {
+        AllocGuardMarkUnsteady();
+        renderer.enemyLod.resize(snapshot.debug.enemyCapacity, ENEMY_LOD_MESH);
+        renderer.enemyLodGeneration.resize(snapshot.debug.enemyCapacity, 0u);
+    }
+
+    if (!renderer.impostorTextured) {
+        if (const Texture2D* sprite = GetTexture(renderer.impostorSprite)) {
+            renderer.impostorMaterial.maps[MATERIAL_MAP_DIFFUSE].texture = *sprite;
+            renderer.impostorTextured = true;
+        }
+    }
+
+    FrameVector<Matrix> enemies;
+    FrameVector<Matrix> impostors;
+    enemies.reserve(snapshot.enemies.size());
+    impostors.reserve(snapshot.enemies.size());
+    for (const EnemyView& e : snapshot.enemies) {
+        const Vector3 pos  = Vector3Lerp(e.prevPosition, e.position, alpha);
+        const Vector3 half = Vector3Scale(e.size, 0.5f);
+        if (!AABBInFrustum(frustum, Vector3Subtract(pos, half), Vector3Add(pos, half))) {
+            renderer.stats.enemiesCulled++;
+            continue;
+        }
+        const float distSq = Vector3DistanceSqr(pos, camera.position);
+        if (e.handle.slot < renderer.enemyLod.size() && EnemyLodFor(e.handle, distSq) == ENEMY_LOD_IMPOSTOR) {
+            const Color tint = renderer.impostorTextured ? WHITE : DARKPURPLE;
+            impostors.push_back(PackInstance(pos, e.size, e.flashing ? RED : tint));
+        } else {
+            enemies.push_back(PackInstance(pos, e.size, e.flashing ? RED : DARKPURPLE));
+        }
+    }
+
+    // Rounds are a few millimetres across: a 12-triangle cube reads as a sphere
+    const float d = snapshot.roundRadius * 2.0f;
+    FrameVector<Matrix> rounds;
+    rounds.reserve(snapshot.rounds.size());
+    for (const RoundView& round : snapshot.rounds) {
+        const Vector3 pos = Vector3Lerp(round.prevPosition, round.position, alpha);
+        if (!SphereInFrustum(frustum, pos, snapshot.roundRadius)) {
+            renderer.stats.projectilesCulled++;
+            continue;
+        }
+        rounds.push_back(PackInstance(pos, { d, d, d }, YELLOW));
+    }
+
+    renderer.stats.enemyInstances      = (int)enemies.size();
+    renderer.stats.enemyImpostors      = (int)impostors.size();
+    renderer.stats.projectileInstances = (int)rounds.size();
+
+    // Tracers are a handful of lines at most, so they go through the immediate batch
+    for (const Tracer& tracer : snapshot.tracers) {
+        if (tracer.timeLeft <= 0.0f) continue;
+        DrawLine3D(tracer.start, tracer.end, Fade(YELLOW, tracer.timeLeft / tracerLifetime));
+        renderer.stats.tracers++;
+    }
+
+    if (renderer.instancing) {
+        SubmitInstances(visiblePlatforms);
+        SubmitInstances(enemies);
+        SubmitInstances(rounds);
+        if (renderer.impostors)
+            SubmitImpostors(impostors, camera);
+        else
+            DrawImpostorsImmediate(impostors, camera);
+        return;
+    }
+
+    // Immediate-mode fallback for contexts without instancing
+    for (const auto* list : { &visiblePlatforms, &enemies, &rounds }) {
+        for (const Matrix& m : *list) {
+            const Color c = { (unsigned char)(m.m3 * 255.0f + 0.5f), (unsigned char)(m.m7 * 255.0f + 0.5f),
+                              (unsigned char)(m.m11 * 255.0f + 0.5f), (unsigned char)(m.m15 * 255.0f + 0.5f) };
+            DrawCube({ m.m12, m.m13, m.m14 }, m.m0, m.m5, m.m10, c);
+            renderer.stats.drawCalls++;
+        }
+    }
+    DrawImpostorsImmediate(impostors, camera);
+}
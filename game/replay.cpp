@@ -0,0 +1,219 @@
+#include "replay.h"
+#include <algorithm>
+#include <cstring>
+
+// Record tags. A tick record is a flags byte optionally followed by its payload:
+// u16 button mask, then two f32 mouse deltas.
+enum : uint8_t {
+    replayTickRestart  = 0x01,
+    replayTickButtons  = 0x02,
+    replayTickMouse    = 0x04,
+    replayChecksumTag  = 0x40,   // u64 checksum of the state after the last tick
+    replayRepeatTag    = 0x80,   // low 7 bits: the last tick's input repeats 1..127 times
+};
+
+constexpr uint32_t replayMaxRun     = 0x7F;
+constexpr size_t   replayBufferSize = 64u << 10;
+
+struct ReplayFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    ReplaySetup setup;
+};
+
+static uint16_t PackButtons(const TickInput& in) {
+    const bool bits[] = { in.moveForward, in.moveBack, in.moveLeft, in.moveRight, in.running,
+                          in.crouching, in.jumpPressed, in.firePressed, in.switchWeaponPressed };
+    uint16_t mask = 0;
+    for (int i = 0; i < (int)(sizeof(bits) / sizeof(bits[0])); ++i)
+        if (bits[i]) mask |= (uint16_t)(1u << i);
+    return mask;
+}
+
+static void UnpackButtons(uint16_t mask, TickInput& in) {
+    bool* bits[] = { &in.moveForward, &in.moveBack, &in.moveLeft, &in.moveRight, &in.running,
+                     &in.crouching, &in.jumpPressed, &in.firePressed, &in.switchWeaponPressed };
+    for (int i = 0; i < (int)(sizeof(bits) / sizeof(bits[0])); ++i)
+        *bits[i] = (mask >> i) & 1u;
+}
+
+static bool SameInput(const TickInput& a, const TickInput& b) {
+    return PackButtons(a) == PackButtons(b) &&
+           memcmp(&a.mouseDelta, &b.mouseDelta, sizeof(a.mouseDelta)) == 0;
+}
+
+// -----------------------------------------------------------------------------
+// Recording
+// -----------------------------------------------------------------------------
+static void Put(ReplayWriter& writer, const void* bytes, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+    writer.buffer.insert(writer.buffer.end(), p, p + size);
+}
+
+static void Flush(ReplayWriter& writer) {
+    if (!writer.buffer.empty())
+        fwrite(writer.buffer.data(), 1, writer.buffer.size(), writer.file);
+    writer.buffer.clear();
+}
+
+static void FlushRepeats(ReplayWriter& writer) {
+    while (writer.repeat > 0) {
+        const uint32_t run = std::min(writer.repeat, replayMaxRun);
+        const uint8_t tag = (uint8_t)(replayRepeatTag | run);
+        Put(writer, &tag, 1);
+        writer.repeat -= run;
+    }
+}
+
+bool ReplayBeginRecording(ReplayWriter& writer, const char* path, const ReplaySetup& setup) {
+    ReplayEndRecording(writer);
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    ReplayFileHeader header = {};
+    header.magic   = replayMagic;
+    header.version = replayVersion;
+    header.setup   = setup;
+    if (header.setup.checksumInterval <= 0)
+        header.setup.checksumInterval = replayDefaultChecksumInterval;
+    fwrite(&header, sizeof(header), 1, file);
+
+    writer = {};
+    writer.file = file;
+    writer.buffer.reserve(replayBufferSize);
+    writer.checksumInterval = header.setup.checksumInterval;
+    return true;
+}
+
+void ReplayRecordTick(ReplayWriter& writer, const TickInput& input, bool restarted) {
+    if (!writer.file) return;
+    writer.ticks++;
+
+    if (!restarted && writer.ticks > 1 && SameInput(input, writer.last)) {
+        writer.repeat++;
+        return;
+    }
+    FlushRepeats(writer);
+
+    const uint16_t buttons = PackButtons(input);
+    uint8_t flags = restarted ? replayTickRestart : 0;
+    if (buttons != PackButtons(writer.last)) flags |= replayTickButtons;
+    if (input.mouseDelta.x != 0.0f || input.mouseDelta.y != 0.0f) flags |= replayTickMouse;
+
+    Put(writer, &flags, 1);
+    if (flags & replayTickButtons) Put(writer, &buttons, sizeof(buttons));
+    if (flags & replayTickMouse)   Put(writer, &input.mouseDelta, sizeof(input.mouseDelta));
+    writer.last = input;
+
+    if (writer.buffer.size() > replayBufferSize - 64) Flush(writer);
+}
+
+bool ReplayChecksumDue(const ReplayWriter& writer) {
+    return writer.file && writer.ticks > 0 && writer.ticks % (uint64_t)writer.checksumInterval == 0;
+}
+
+void ReplayRecordChecksum(ReplayWriter& writer, uint64_t checksum) {
+    if (!ReplayChecksumDue(writer)) return;
+    FlushRepeats(writer);
+    const uint8_t tag = replayChecksumTag;
+    Put(writer, &tag, 1);
+    Put(writer, &checksum, sizeof(checksum));
+}
+
+void ReplayEndRecording(ReplayWriter& writer) {
+    if (!writer.file) return;
+    FlushRepeats(writer);
+    Flush(writer);
+    fclose(writer.file);
+    writer = {};
+}
+
+bool ReplayRecording(const ReplayWriter& writer) {
+    return writer.file != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Playback
+// -----------------------------------------------------------------------------
+bool LoadReplay(ReplayReader& reader, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    ReplayFileHeader header;
+    const bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                    header.magic == replayMagic && header.version == replayVersion &&
+                    header.setup.checksumInterval > 0 && header.setup.tickRate > 0;
+    if (!ok) {
+        fclose(file);
+        return false;
+    }
+
+    reader = {};
+    reader.setup = header.setup;
+    reader.setup.level[sizeof(reader.setup.level) - 1] = '\0';
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        reader.data.insert(reader.data.end(), chunk, chunk + n);
+    fclose(file);
+    return true;
+}
+
+static bool Get(ReplayReader& reader, void* out, size_t size) {
+    if (reader.cursor + size > reader.data.size()) return false;
+    memcpy(out, reader.data.data() + reader.cursor, size);
+    reader.cursor += size;
+    return true;
+}
+
+bool NextReplayTick(ReplayReader& reader, TickInput& input, bool& restarted) {
+    restarted = false;
+    if (reader.repeat > 0) {
+        reader.repeat--;
+        input = reader.last;
+        reader.ticks++;
+        return true;
+    }
+
+    // Checksums belong to the tick before; VerifyReplayChecksum consumes them
+    uint8_t tag;
+    while (Get(reader, &tag, 1)) {
+        if (tag & replayRepeatTag) {
+            reader.repeat = (tag & replayMaxRun) - 1;
+            input = reader.last;
+            reader.ticks++;
+            return true;
+        }
+        if (tag == replayChecksumTag) {
+            reader.cursor += sizeof(uint64_t);
+            continue;
+        }
+
+        TickInput next = {};
+        uint16_t buttons = PackButtons(reader.last);
+        if ((tag & replayTickButtons) && !Get(reader, &buttons, sizeof(buttons))) return false;
+        UnpackButtons(buttons, next);
+        if ((tag & replayTickMouse) && !Get(reader, &next.mouseDelta, sizeof(next.mouseDelta))) return false;
+        restarted   = (tag & replayTickRestart) != 0;
+        reader.last = next;
+        input       = next;
+        reader.ticks++;
+        return true;
+    }
+    return false;
+}
+
+bool ReplayChecksumPending(const ReplayReader& reader) {
+    // A pending repeat means the next record is not for this tick
+    return reader.repeat == 0 && reader.cursor < reader.data.size() &&
+           reader.data[reader.cursor] == replayChecksumTag;
+}
+
+bool VerifyReplayChecksum(ReplayReader& reader, uint64_t checksum, uint64_t& expected) {
+    if (!ReplayChecksumPending(reader)) return true;
+
+    reader.cursor++;
+    if (!Get(reader, &expected, sizeof(expected))) return true;
+    reader.checksumsVerified++;
+    return expected == checksum;
+}
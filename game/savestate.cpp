@@ -0,0 +1,369 @@
+#include "savestate.h"
+#include "game.h"
+#include "arena.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+enum SavePlayerField {
+    PLAYER_POS_X = 0, PLAYER_POS_Y, PLAYER_POS_Z,
+    PLAYER_VEL_Y,
+    PLAYER_SPEED,
+    PLAYER_AIRBORNE_SPEED,
+    PLAYER_YAW,
+    PLAYER_PITCH,
+    PLAYER_SLIDE_TIMER,
+    PLAYER_SPRINT_TIMER,
+    PLAYER_SURVIVAL_TIME,
+    PLAYER_FLAGS,                 // playerFlag* bits
+    PLAYER_JUMP_COUNT,
+    PLAYER_HEALTH,
+    PLAYER_KILLS,
+    PLAYER_SHOTS_FIRED,
+    PLAYER_SHOTS_HIT,
+    PLAYER_FIELD_COUNT
+};
+static_assert(PLAYER_FIELD_COUNT == savePlayerFields, "savestate.h field count is stale");
+
+enum : int32_t {
+    playerFlagSliding         = 1 << 0,
+    playerFlagSprintExhausted = 1 << 1,
+    playerFlagPrevCrouching   = 1 << 2,
+    playerFlagWasOnGround     = 1 << 3,
+    playerFlagSlideQueued     = 1 << 4,
+};
+
+enum SaveEnemyField {
+    ENEMY_POS_X = 0, ENEMY_POS_Y, ENEMY_POS_Z,
+    ENEMY_SIZE_X, ENEMY_SIZE_Y, ENEMY_SIZE_Z,
+    ENEMY_HEALTH,
+    ENEMY_FLASH_TIMER,
+    ENEMY_DAMAGE_COOLDOWN,
+    ENEMY_FIELD_COUNT
+};
+static_assert(ENEMY_FIELD_COUNT == saveEnemyFields, "savestate.h field count is stale");
+
+enum SaveRoundField {
+    ROUND_POS_X = 0, ROUND_POS_Y, ROUND_POS_Z,
+    ROUND_VEL_X, ROUND_VEL_Y, ROUND_VEL_Z,
+    ROUND_LIFETIME,
+    ROUND_FIELD_COUNT
+};
+static_assert(ROUND_FIELD_COUNT == saveRoundFields, "savestate.h field count is stale");
+
+// Header flag: encoded against a baseline, whose tick follows the state's
+constexpr uint8_t saveStateDelta = 0x01;
+
+static const int32_t zeroRecord[32] = {};
+static_assert(savePlayerFields <= 32 && saveEnemyFields <= 32 && saveRoundFields <= 32 &&
+              SAVE_GLOBAL_COUNT <= 32, "field masks are 32 bits");
+
+// -----------------------------------------------------------------------------
+// Capture / restore
+// -----------------------------------------------------------------------------
+void CaptureEntities(SaveState& state, const Player& player, const World& world) {
+    int32_t* p = state.player;
+    p[PLAYER_POS_X]          = QuantizeValue(player.position.x, savePositionStep);
+    p[PLAYER_POS_Y]          = QuantizeValue(player.position.y, savePositionStep);
+    p[PLAYER_POS_Z]          = QuantizeValue(player.position.z, savePositionStep);
+    p[PLAYER_VEL_Y]          = QuantizeValue(player.velocityY, saveVelocityStep);
+    p[PLAYER_SPEED]          = QuantizeValue(player.speed, saveVelocityStep);
+    p[PLAYER_AIRBORNE_SPEED] = QuantizeValue(player.airborneSpeed, saveVelocityStep);
+    p[PLAYER_YAW]            = QuantizeValue(player.cameraYaw, saveAngleStep);
+    p[PLAYER_PITCH]          = QuantizeValue(player.cameraPitch, saveAngleStep);
+    p[PLAYER_SLIDE_TIMER]    = QuantizeValue(player.slideTimer, saveTimeStep);
+    p[PLAYER_SPRINT_TIMER]   = QuantizeValue(player.sprintTimer, saveTimeStep);
+    p[PLAYER_SURVIVAL_TIME]  = QuantizeValue(player.survivalTime, saveTimeStep);
+    p[PLAYER_FLAGS]          = (player.isSliding       ? playerFlagSliding         : 0) |
+                               (player.sprintExhausted ? playerFlagSprintExhausted : 0) |
+                               (player.prevCrouching   ? playerFlagPrevCrouching   : 0) |
+                               (player.wasOnGround     ? playerFlagWasOnGround     : 0) |
+                               (player.slideQueued     ? playerFlagSlideQueued     : 0);
+    p[PLAYER_JUMP_COUNT]     = player.jumpCount;
+    p[PLAYER_HEALTH]         = player.health;
+    p[PLAYER_KILLS]          = player.enemiesDefeated;
+    p[PLAYER_SHOTS_FIRED]    = player.shotsFired;
+    p[PLAYER_SHOTS_HIT]      = player.shotsHit;
+
+    const size_t enemyCount = world.enemies.size();
+    state.enemyHandles.resize(enemyCount);
+    state.enemies.resize(enemyCount * saveEnemyFields);
+    for (size_t i = 0; i < enemyCount; ++i) {
+        const Enemy& e = world.enemies[i];
+        int32_t* f = &state.enemies[i * saveEnemyFields];
+        f[ENEMY_POS_X]           = QuantizeValue(e.position.x, savePositionStep);
+        f[ENEMY_POS_Y]           = QuantizeValue(e.position.y, savePositionStep);
+        f[ENEMY_POS_Z]           = QuantizeValue(e.position.z, savePositionStep);
+        f[ENEMY_SIZE_X]          = QuantizeValue(e.size.x, savePositionStep);
+        f[ENEMY_SIZE_Y]          = QuantizeValue(e.size.y, savePositionStep);
+        f[ENEMY_SIZE_Z]          = QuantizeValue(e.size.z, savePositionStep);
+        f[ENEMY_HEALTH]          = e.health;
+        f[ENEMY_FLASH_TIMER]     = QuantizeValue(e.flashTimer, saveTimeStep);
+        f[ENEMY_DAMAGE_COOLDOWN] = QuantizeValue(e.damageCooldown, saveTimeStep);
+        state.enemyHandles[i] = EntityHandleAt(world.enemies, i);
+    }
+
+    const ProjectilePool& pool = world.projectiles;
+    state.rounds.resize(pool.count * saveRoundFields);
+    for (size_t i = 0; i < pool.count; ++i) {
+        int32_t* f = &state.rounds[i * saveRoundFields];
+        f[ROUND_POS_X]    = QuantizeValue(pool.posX[i], savePositionStep);
+        f[ROUND_POS_Y]    = QuantizeValue(pool.posY[i], savePositionStep);
+        f[ROUND_POS_Z]    = QuantizeValue(pool.posZ[i], savePositionStep);
+        f[ROUND_VEL_X]    = QuantizeValue(pool.velX[i], saveVelocityStep);
+        f[ROUND_VEL_Y]    = QuantizeValue(pool.velY[i], saveVelocityStep);
+        f[ROUND_VEL_Z]    = QuantizeValue(pool.velZ[i], saveVelocityStep);
+        f[ROUND_LIFETIME] = QuantizeValue(pool.lifetime[i], saveTimeStep);
+    }
+}
+
+bool RestoreEntities(const SaveState& state, Player& player, World& world) {
+    const int32_t* p = state.player;
+    player.position = { DequantizeValue(p[PLAYER_POS_X], savePositionStep),
+                        DequantizeValue(p[PLAYER_POS_Y], savePositionStep),
+                        DequantizeValue(p[PLAYER_POS_Z], savePositionStep) };
+    player.prevPosition    = player.position;
+    player.velocityY       = DequantizeValue(p[PLAYER_VEL_Y], saveVelocityStep);
+    player.speed           = DequantizeValue(p[PLAYER_SPEED], saveVelocityStep);
+    player.airborneSpeed   = DequantizeValue(p[PLAYER_AIRBORNE_SPEED], saveVelocityStep);
+    player.cameraYaw       = DequantizeValue(p[PLAYER_YAW], saveAngleStep);
+    player.cameraPitch     = DequantizeValue(p[PLAYER_PITCH], saveAngleStep);
+    player.slideTimer      = DequantizeValue(p[PLAYER_SLIDE_TIMER], saveTimeStep);
+    player.sprintTimer     = DequantizeValue(p[PLAYER_SPRINT_TIMER], saveTimeStep);
+    player.survivalTime    = DequantizeValue(p[PLAYER_SURVIVAL_TIME], saveTimeStep);
+    player.isSliding       = (p[PLAYER_FLAGS] & playerFlagSliding) != 0;
+    player.sprintExhausted = (p[PLAYER_FLAGS] & playerFlagSprintExhausted) != 0;
+    player.prevCrouching   = (p[PLAYER_FLAGS] & playerFlagPrevCrouching) != 0;
+    player.wasOnGround     = (p[PLAYER_FLAGS] & playerFlagWasOnGround) != 0;
+    player.slideQueued     = (p[PLAYER_FLAGS] & playerFlagSlideQueued) != 0;
+    player.jumpCount       = p[PLAYER_JUMP_COUNT];
+    player.health          = p[PLAYER_HEALTH];
+    player.enemiesDefeated = p[PLAYER_KILLS];
+    player.shotsFired      = p[PLAYER_SHOTS_FIRED];
+    player.shotsHit        = p[PLAYER_SHOTS_HIT];
+
+    ClearProjectiles(world.projectiles);
+    const uint32_t enemyCount = (uint32_t)state.enemyHandles.size();
+    if (!RestoreHandleTable(world.enemies.handles, state.enemyHandles.data(), enemyCount))
+        return false;
+    for (uint32_t i = 0; i < enemyCount; ++i) {
+        const int32_t* f = &state.enemies[i * saveEnemyFields];
+        Enemy& e = world.enemies[i];
+        e.position = { DequantizeValue(f[ENEMY_POS_X], savePositionStep),
+                       DequantizeValue(f[ENEMY_POS_Y], savePositionStep),
+                       DequantizeValue(f[ENEMY_POS_Z], savePositionStep) };
+        e.prevPosition   = e.position;
+        e.size           = { DequantizeValue(f[ENEMY_SIZE_X], savePositionStep),
+                             DequantizeValue(f[ENEMY_SIZE_Y], savePositionStep),
+                             DequantizeValue(f[ENEMY_SIZE_Z], savePositionStep) };
+        e.health         = f[ENEMY_HEALTH];
+        e.flashTimer     = DequantizeValue(f[ENEMY_FLASH_TIMER], saveTimeStep);
+        e.damageCooldown = DequantizeValue(f[ENEMY_DAMAGE_COOLDOWN], saveTimeStep);
+    }
+
+    // Spawning in order reproduces the dense order, which the simulation iterates in
+    const size_t roundCount = std::min(state.rounds.size() / saveRoundFields, world.projectiles.capacity);
+    for (size_t i = 0; i < roundCount; ++i) {
+        const int32_t* f = &state.rounds[i * saveRoundFields];
+        SpawnProjectile(world.projectiles,
+            { DequantizeValue(f[ROUND_POS_X], savePositionStep),
+              DequantizeValue(f[ROUND_POS_Y], savePositionStep),
+              DequantizeValue(f[ROUND_POS_Z], savePositionStep) },
+            { DequantizeValue(f[ROUND_VEL_X], saveVelocityStep),
+              DequantizeValue(f[ROUND_VEL_Y], saveVelocityStep),
+              DequantizeValue(f[ROUND_VEL_Z], saveVelocityStep) },
+            DequantizeValue(f[ROUND_LIFETIME], saveTimeStep));
+    }
+    return true;
+}
+
+bool SaveStatesEqual(const SaveState& a, const SaveState& b) {
+    return a.tick == b.tick &&
+           memcmp(a.globals, b.globals, sizeof(a.globals)) == 0 &&
+           memcmp(a.player, b.player, sizeof(a.player)) == 0 &&
+           a.enemyHandles == b.enemyHandles &&
+           a.enemies == b.enemies &&
+           a.rounds == b.rounds;
+}
+
+// -----------------------------------------------------------------------------
+// Encoding
+// -----------------------------------------------------------------------------
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+// Differences wrap like the int32 fields they come from, so any pair is exact
+static uint32_t ZigZag(int32_t a, int32_t b) {
+    const int32_t d = (int32_t)((uint32_t)a - (uint32_t)b);
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+static int32_t UnZigZag(uint32_t z, int32_t base) {
+    const int32_t d = (int32_t)((z >> 1) ^ (0u - (z & 1u)));
+    return (int32_t)((uint32_t)base + (uint32_t)d);
+}
+
+static void PutRecord(std::vector<uint8_t>& out, const int32_t* fields, const int32_t* base, int count) {
+    uint32_t mask = 0;
+    for (int i = 0; i < count; ++i)
+        if (fields[i] != base[i]) mask |= 1u << i;
+    PutVarint(out, mask);
+    for (int i = 0; i < count; ++i)
+        if (mask & (1u << i)) PutVarint(out, ZigZag(fields[i], base[i]));
+}
+
+// Baseline enemy by slot, so removals that reorder the dense range still pair
+// each enemy with itself. Entries are dense index + 1, 0 for none.
+static FrameVector<uint32_t> IndexBaselineSlots(const SaveState* baseline) {
+    FrameVector<uint32_t> bySlot;
+    if (!baseline) return bySlot;
+    uint32_t slots = 0;
+    for (const EntityHandle& h : baseline->enemyHandles) slots = std::max(slots, h.slot + 1);
+    bySlot.assign(slots, 0u);
+    for (size_t i = 0; i < baseline->enemyHandles.size(); ++i)
+        bySlot[baseline->enemyHandles[i].slot] = (uint32_t)i + 1;
+    return bySlot;
+}
+
+void EncodeSaveState(const SaveState& state, const SaveState* baseline, std::vector<uint8_t>& out) {
+    const uint8_t header[7] = {
+        (uint8_t)saveStateMagic, (uint8_t)(saveStateMagic >> 8),
+        (uint8_t)(saveStateMagic >> 16), (uint8_t)(saveStateMagic >> 24),
+        (uint8_t)saveStateVersion, (uint8_t)(saveStateVersion >> 8),
+        baseline ? saveStateDelta : uint8_t(0)
+    };
+    out.insert(out.end(), header, header + sizeof(header));
+    PutVarint(out, state.tick);
+    if (baseline) PutVarint(out, baseline->tick);
+
+    PutRecord(out, state.globals, baseline ? baseline->globals : zeroRecord, SAVE_GLOBAL_COUNT);
+    PutRecord(out, state.player, baseline ? baseline->player : zeroRecord, savePlayerFields);
+
+    const FrameVector<uint32_t> baseBySlot = IndexBaselineSlots(baseline);
+    PutVarint(out, state.enemyHandles.size());
+    for (size_t i = 0; i < state.enemyHandles.size(); ++i) {
+        const EntityHandle h = state.enemyHandles[i];
+        const uint32_t match = h.slot < baseBySlot.size() ? baseBySlot[h.slot] : 0;
+        const int32_t* base = match ? &baseline->enemies[(match - 1) * saveEnemyFields] : zeroRecord;
+        const uint32_t baseGeneration = match ? baseline->enemyHandles[match - 1].generation : 0;
+
+        PutVarint(out, h.slot);
+        PutVarint(out, ZigZag((int32_t)h.generation, (int32_t)baseGeneration));
+        PutRecord(out, &state.enemies[i * saveEnemyFields], base, saveEnemyFields);
+    }
+
+    // Rounds pair up by dense index; they fly straight, so the positions move
+    // by about the same step each tick and the velocities not at all
+    const size_t rounds     = state.rounds.size() / saveRoundFields;
+    const size_t baseRounds = baseline ? baseline->rounds.size() / saveRoundFields : 0;
+    PutVarint(out, rounds);
+    for (size_t i = 0; i < rounds; ++i) {
+        const int32_t* base = i < baseRounds ? &baseline->rounds[i * saveRoundFields] : zeroRecord;
+        PutRecord(out, &state.rounds[i * saveRoundFields], base, saveRoundFields);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Decoding
+// -----------------------------------------------------------------------------
+struct SaveReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+
+    uint64_t Varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) break;
+            const uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+static void GetRecord(SaveReader& in, int32_t* fields, const int32_t* base, int count) {
+    const uint64_t mask = in.Varint();
+    if (mask >> count) in.ok = false;
+    for (int i = 0; i < count; ++i)
+        fields[i] = (mask & (1u << i)) ? UnZigZag((uint32_t)in.Varint(), base[i]) : base[i];
+}
+
+bool DecodeSaveState(const uint8_t* data, size_t size, const SaveState* baseline, SaveState& state) {
+    if (size < 7) return false;
+    const uint32_t magic   = data[0] | data[1] << 8 | data[2] << 16 | (uint32_t)data[3] << 24;
+    const uint16_t version = (uint16_t)(data[4] | data[5] << 8);
+    const bool delta = (data[6] & saveStateDelta) != 0;
+    if (magic != saveStateMagic || version != saveStateVersion) return false;
+
+    SaveReader in = { data + 7, data + size, true };
+    state.tick = in.Varint();
+    if (delta) {
+        const uint64_t baseTick = in.Varint();
+        if (!baseline || baseline->tick != baseTick) return false;
+    } else {
+        baseline = nullptr;
+    }
+
+    GetRecord(in, state.globals, baseline ? baseline->globals : zeroRecord, SAVE_GLOBAL_COUNT);
+    GetRecord(in, state.player, baseline ? baseline->player : zeroRecord, savePlayerFields);
+
+    // Every record is at least two bytes, which bounds the counts before anything is sized
+    const uint64_t enemies = in.Varint();
+    if (!in.ok || enemies > (uint64_t)(in.end - in.p) / 2) return false;
+    const FrameVector<uint32_t> baseBySlot = IndexBaselineSlots(baseline);
+    state.enemyHandles.resize(enemies);
+    state.enemies.resize(enemies * saveEnemyFields);
+    for (size_t i = 0; i < enemies && in.ok; ++i) {
+        const uint64_t slot = in.Varint();
+        if (slot > UINT32_MAX) return false;
+        const uint32_t match = slot < baseBySlot.size() ? baseBySlot[slot] : 0;
+        const int32_t* base = match ? &baseline->enemies[(match - 1) * saveEnemyFields] : zeroRecord;
+        const uint32_t baseGeneration = match ? baseline->enemyHandles[match - 1].generation : 0;
+
+        state.enemyHandles[i].slot       = (uint32_t)slot;
+        state.enemyHandles[i].generation = (uint32_t)UnZigZag((uint32_t)in.Varint(), (int32_t)baseGeneration);
+        GetRecord(in, &state.enemies[i * saveEnemyFields], base, saveEnemyFields);
+    }
+
+    const uint64_t rounds = in.Varint();
+    if (!in.ok || rounds > (uint64_t)(in.end - in.p)) return false;
+    const size_t baseRounds = baseline ? baseline->rounds.size() / saveRoundFields : 0;
+    state.rounds.resize(rounds * saveRoundFields);
+    for (size_t i = 0; i < rounds && in.ok; ++i) {
+        const int32_t* base = i < baseRounds ? &baseline->rounds[i * saveRoundFields] : zeroRecord;
+        GetRecord(in, &state.rounds[i * saveRoundFields], base, saveRoundFields);
+    }
+    return in.ok && in.p == in.end;
+}
+
+// -----------------------------------------------------------------------------
+// Files
+// -----------------------------------------------------------------------------
+bool WriteSaveStateFile(const char* path, const SaveState& state) {
+    std::vector<uint8_t> bytes;
+    EncodeSaveState(state, nullptr, bytes);
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    const bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool ReadSaveStateFile(const char* path, SaveState& state) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    fclose(file);
+    return DecodeSaveState(bytes.data(), bytes.size(), nullptr, state);
+}
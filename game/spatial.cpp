@@ -0,0 +1,162 @@
+#include "spatial.h"
+#include "game.h"
+#include <cfloat>
+
+// -----------------------------------------------------------------------------
+// Platform grid
+// -----------------------------------------------------------------------------
+// Points the query views at the grid's own vectors
+static void BindGridStorage(PlatformGrid& grid) {
+    grid.cellStart      = grid.cellStartData.data();
+    grid.cellItems      = grid.cellItemsData.data();
+    grid.itemCellMinX   = grid.itemCellMinXData.data();
+    grid.itemCellMinZ   = grid.itemCellMinZData.data();
+    grid.largeItems     = grid.largeItemsData.data();
+    grid.cellItemCount  = (uint32_t)grid.cellItemsData.size();
+    grid.largeItemCount = (uint32_t)grid.largeItemsData.size();
+}
+
+void BuildPlatformGrid(PlatformGrid& grid, const Platform* platforms, size_t count, float cellSize,
+                       const XZBounds* clip) {
+    std::vector<uint32_t>& cellStart = grid.cellStartData;
+    std::vector<uint32_t>& cellItems = grid.cellItemsData;
+    std::vector<uint32_t>& largeItems = grid.largeItemsData;
+    cellStart.clear();
+    cellItems.clear();
+    largeItems.clear();
+    grid.itemCellMinXData.assign(count, 0);
+    grid.itemCellMinZData.assign(count, 0);
+    grid.cellSize    = cellSize;
+    grid.invCellSize = 1.0f / cellSize;
+    grid.cellsX = 0;
+    grid.cellsZ = 0;
+
+    if (count == 0) {
+        BindGridStorage(grid);
+        return;
+    }
+
+    float minX = FLT_MAX, minZ = FLT_MAX, maxX = -FLT_MAX, maxZ = -FLT_MAX;
+    for (size_t i = 0; i < count; ++i) {
+        const Platform& p = platforms[i];
+        minX = std::min(minX, p.position.x - p.size.x * 0.5f);
+        maxX = std::max(maxX, p.position.x + p.size.x * 0.5f);
+        minZ = std::min(minZ, p.position.z - p.size.z * 0.5f);
+        maxZ = std::max(maxZ, p.position.z + p.size.z * 0.5f);
+    }
+    if (clip) {
+        minX = std::max(minX, clip->minX); maxX = std::min(maxX, clip->maxX);
+        minZ = std::max(minZ, clip->minZ); maxZ = std::min(maxZ, clip->maxZ);
+        if (minX > maxX || minZ > maxZ) {
+            minX = maxX = clip->minX;
+            minZ = maxZ = clip->minZ;
+        }
+    }
+
+    grid.originX = minX;
+    grid.originZ = minZ;
+    grid.cellsX  = std::max(1, (int)((maxX - minX) * grid.invCellSize) + 1);
+    grid.cellsZ  = std::max(1, (int)((maxZ - minZ) * grid.invCellSize) + 1);
+
+    const size_t cellCount = (size_t)grid.cellsX * grid.cellsZ;
+    cellStart.assign(cellCount + 1, 0);
+
+    auto cellRange = [&](const Platform& p, int& c0x, int& c0z, int& c1x, int& c1z) {
+        c0x = GridCellCoord(p.position.x - p.size.x * 0.5f, grid.originX, grid.invCellSize, grid.cellsX);
+        c0z = GridCellCoord(p.position.z - p.size.z * 0.5f, grid.originZ, grid.invCellSize, grid.cellsZ);
+        c1x = GridCellCoord(p.position.x + p.size.x * 0.5f, grid.originX, grid.invCellSize, grid.cellsX);
+        c1z = GridCellCoord(p.position.z + p.size.z * 0.5f, grid.originZ, grid.invCellSize, grid.cellsZ);
+    };
+
+    // Pass 1: count entries per cell (counting sort keeps the cell lists contiguous)
+    for (size_t i = 0; i < count; ++i) {
+        int c0x, c0z, c1x, c1z;
+        cellRange(platforms[i], c0x, c0z, c1x, c1z);
+        if ((c1x - c0x + 1) * (c1z - c0z + 1) > platformGridMaxItemCells) {
+            largeItems.push_back((uint32_t)i);
+            continue;
+        }
+        grid.itemCellMinXData[i] = c0x;
+        grid.itemCellMinZData[i] = c0z;
+        for (int cz = c0z; cz <= c1z; ++cz)
+            for (int cx = c0x; cx <= c1x; ++cx)
+                cellStart[cz * grid.cellsX + cx + 1]++;
+    }
+
+    for (size_t c = 0; c < cellCount; ++c)
+        cellStart[c + 1] += cellStart[c];
+
+    // Pass 2: scatter platform indices into their cells
+    cellItems.resize(cellStart[cellCount]);
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    size_t large = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (large < largeItems.size() && largeItems[large] == i) {
+            ++large;
+            continue;
+        }
+        int c0x, c0z, c1x, c1z;
+        cellRange(platforms[i], c0x, c0z, c1x, c1z);
+        for (int cz = c0z; cz <= c1z; ++cz)
+            for (int cx = c0x; cx <= c1x; ++cx)
+                cellItems[cursor[cz * grid.cellsX + cx]++] = (uint32_t)i;
+    }
+    BindGridStorage(grid);
+}
+
+// -----------------------------------------------------------------------------
+// Enemy grid
+// -----------------------------------------------------------------------------
+// Keep roughly two buckets per enemy so chains stay short
+static uint32_t EnemyGridBuckets(size_t count) {
+    uint32_t buckets = 64;
+    while (buckets < count * 2) buckets <<= 1;
+    return buckets;
+}
+
+void ReserveEnemyGrid(EnemyGrid& grid, size_t maxCount) {
+    grid.bucketStart.reserve(EnemyGridBuckets(maxCount) + 1);
+    grid.cellX.reserve(maxCount);
+    grid.cellZ.reserve(maxCount);
+    grid.bucketOf.reserve(maxCount);
+    grid.entries.reserve(maxCount);
+}
+
+void RebuildEnemyGrid(EnemyGrid& grid, const Enemy* enemies, size_t count, float cellSize) {
+    grid.cellSize    = cellSize;
+    grid.invCellSize = 1.0f / cellSize;
+
+    const uint32_t buckets = EnemyGridBuckets(count);
+    grid.bucketMask = buckets - 1;
+
+    grid.bucketStart.assign(buckets + 1, 0);
+    grid.cellX.resize(count);
+    grid.cellZ.resize(count);
+    grid.bucketOf.resize(count);
+    grid.entries.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const int cx = WorldToCell(enemies[i].position.x, grid.invCellSize);
+        const int cz = WorldToCell(enemies[i].position.z, grid.invCellSize);
+        const uint32_t bucket = HashCell(cx, cz, grid.bucketMask);
+        grid.cellX[i]    = cx;
+        grid.cellZ[i]    = cz;
+        grid.bucketOf[i] = bucket;
+        grid.bucketStart[bucket + 1]++;
+    }
+
+    for (uint32_t b = 0; b < buckets; ++b)
+        grid.bucketStart[b + 1] += grid.bucketStart[b];
+
+    // Scatter back to front, decrementing each bucket's end; indices stay ascending
+    // within a bucket and every end lands on the bucket's start
+    for (size_t i = count; i-- > 0;) {
+        const uint32_t bucket = grid.bucketOf[i];
+        grid.entries[--grid.bucketStart[bucket + 1]] = (uint32_t)i;
+    }
+
+    // bucketStart[b + 1] now holds the start of bucket b; shift back into place
+    for (uint32_t b = 0; b < buckets; ++b)
+        grid.bucketStart[b] = grid.bucketStart[b + 1];
+    grid.bucketStart[buckets] = (uint32_t)count;
+}
@@ -1,10 +1,34 @@
 #include "game.h"
 #include "lib.h"
+#include "telemetry.h"
+#include <cstring>
 
-int main()
+int main(int argc, char** argv)
 {
+    // lixtricks [--record out.lxr] [--telemetry out.csv | out.jsonl | udp://host:port]
+    //           [level.lvl | level.lxl | level.lxs]
+    const char* level = nullptr;
+    const char* record = nullptr;
+    const char* telemetry = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--record") && i + 1 < argc) record = argv[++i];
+        else if (!strcmp(argv[i], "--telemetry") && i + 1 < argc) telemetry = argv[++i];
+        else level = argv[i];
+    }
+
     GameInit();
 
+    // Chunk loads have to land on the same tick when the recording is played back
+    if (record)
+        StreamSetSynchronous(true);
+    if (level && !GameLoadLevel(level))
+        TraceLog(LOG_WARNING, "LEVEL: Could not load %s, keeping the built-in arena", level);
+    if (record && !GameRecordReplay(record))
+        TraceLog(LOG_WARNING, "REPLAY: Could not create %s", record);
+    if (telemetry && !TelemetryOpen(telemetry))
+        TraceLog(LOG_WARNING, "TELEMETRY: Could not open %s", telemetry);
+
     while (!WindowShouldClose())
     {
         if (!GameUpdate())
@@ -15,4 +39,4 @@ int main()
     GameCleanup();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,389 @@
+#include "streaming.h"
+#include "arena.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#if !defined(_WIN32)
+    #include <sys/types.h>
+#endif
+
+struct LoadedChunk {
+    uint64_t key;
+    std::vector<Platform> platforms;
+};
+
+// Loader thread state; everything else is only touched by the simulation thread
+struct StreamWorker {
+    std::thread              thread;
+    std::mutex               mutex;
+    std::condition_variable  wake;
+    std::vector<uint32_t>    requests;      // chunk table indices
+    std::vector<LoadedChunk> done;
+    bool                     quit;
+};
+
+struct LevelStream {
+    bool                     active;
+    bool                     synchronous;
+    float                    radius = streamDefaultRadius;
+    FILE*                    file;          // the loader's handle, or ours when synchronous
+    FILE*                    syncFile;      // for blocking loads while the loader runs
+    StreamFileHeader         header;
+    std::vector<Platform>    base;
+    std::vector<StreamChunkEntry> table;
+    std::unordered_map<uint64_t, uint32_t> chunkIndex;       // key -> table index
+    std::map<uint64_t, std::vector<Platform>> resident;      // ordered for stable output
+    std::unordered_set<uint64_t> pending;
+    std::vector<uint64_t>    wanted;        // scratch
+    XZBounds                 window;        // chunk squares within the load radius
+    uint64_t                 loads;
+    uint64_t                 unloads;
+};
+
+static LevelStream  stream;
+static StreamWorker worker;
+
+static uint64_t ChunkKey(int32_t cx, int32_t cz) {
+    return ((uint64_t)(uint32_t)cz << 32) | (uint32_t)cx;
+}
+
+static int32_t ChunkX(uint64_t key) { return (int32_t)(uint32_t)key; }
+static int32_t ChunkZ(uint64_t key) { return (int32_t)(uint32_t)(key >> 32); }
+
+static int32_t ChunkCoord(float v, float chunkSize) {
+    return (int32_t)floorf(v / chunkSize);
+}
+
+// -----------------------------------------------------------------------------
+// Writing
+// -----------------------------------------------------------------------------
+bool WriteStreamedLevel(const char* path, const Platform* platforms, size_t count, float chunkSize) {
+    if (count == 0 || chunkSize <= 0.0f) return false;
+
+    std::vector<Platform> base;
+    std::map<uint64_t, std::vector<Platform>> chunks;
+    for (size_t i = 0; i < count; ++i) {
+        const Platform& p = platforms[i];
+        if (i == 0 || p.size.x > chunkSize || p.size.z > chunkSize) {
+            base.push_back(p);
+            continue;
+        }
+        chunks[ChunkKey(ChunkCoord(p.position.x, chunkSize), ChunkCoord(p.position.z, chunkSize))].push_back(p);
+    }
+
+    StreamFileHeader h = {};
+    memcpy(h.magic, streamFileMagic, 4);
+    h.version             = streamFileVersion;
+    h.platformStride      = (uint32_t)sizeof(Platform);
+    h.chunkSize           = chunkSize;
+    h.basePlatformCount   = (uint32_t)base.size();
+    h.chunkCount          = (uint32_t)chunks.size();
+    h.basePlatformsOffset = sizeof(StreamFileHeader);
+    h.chunkTableOffset    = h.basePlatformsOffset + base.size() * sizeof(Platform);
+
+    std::vector<StreamChunkEntry> table;
+    uint64_t offset = h.chunkTableOffset + chunks.size() * sizeof(StreamChunkEntry);
+    for (const auto& c : chunks) {
+        table.push_back({ ChunkX(c.first), ChunkZ(c.first), (uint32_t)c.second.size(), 0, offset });
+        offset += c.second.size() * sizeof(Platform);
+    }
+    h.fileSize = offset;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1 &&
+              fwrite(base.data(), sizeof(Platform), base.size(), file) == base.size() &&
+              fwrite(table.data(), sizeof(StreamChunkEntry), table.size(), file) == table.size();
+    for (const auto& c : chunks) {
+        if (!ok) break;
+        ok = fwrite(c.second.data(), sizeof(Platform), c.second.size(), file) == c.second.size();
+    }
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+bool IsStreamedLevel(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    char magic[4] = {};
+    const bool streamed = fread(magic, 1, 4, file) == 4 && memcmp(magic, streamFileMagic, 4) == 0;
+    fclose(file);
+    return streamed;
+}
+
+// -----------------------------------------------------------------------------
+// Loading
+// -----------------------------------------------------------------------------
+// Offsets are 64-bit in the file; fseek takes a long, which is 32-bit on Windows
+static bool SeekTo(FILE* file, uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static bool FileLength(FILE* file, uint64_t& length) {
+#if defined(_WIN32)
+    if (_fseeki64(file, 0, SEEK_END) != 0) return false;
+    const __int64 end = _ftelli64(file);
+#else
+    if (fseeko(file, 0, SEEK_END) != 0) return false;
+    const off_t end = ftello(file);
+#endif
+    length = (uint64_t)end;
+    return end >= 0 && SeekTo(file, 0);
+}
+
+static bool SectionFits(uint64_t fileSize, uint64_t offset, uint64_t bytes) {
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+static bool ReadChunk(FILE* file, const StreamChunkEntry& entry, std::vector<Platform>& out) {
+    out.resize(entry.platformCount);
+    if (entry.platformCount == 0) return true;
+    return SeekTo(file, entry.offset) &&
+           fread(out.data(), sizeof(Platform), out.size(), file) == out.size();
+}
+
+static void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    while (true) {
+        worker.wake.wait(lock, [] { return worker.quit || !worker.requests.empty(); });
+        if (worker.quit) return;
+
+        const uint32_t index = worker.requests.back();
+        worker.requests.pop_back();
+        lock.unlock();
+
+        const StreamChunkEntry& entry = stream.table[index];   // immutable while open
+        LoadedChunk chunk = { ChunkKey(entry.chunkX, entry.chunkZ), {} };
+        if (!ReadChunk(stream.file, entry, chunk.platforms)) {
+            TraceLog(LOG_WARNING, "STREAM: Failed to read chunk %d,%d", entry.chunkX, entry.chunkZ);
+            chunk.platforms.clear();
+        }
+
+        lock.lock();
+        worker.done.push_back(std::move(chunk));
+    }
+}
+
+bool StreamOpen(const char* path) {
+    StreamClose();
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    // Counts are checked against the real file before anything is sized from them
+    StreamFileHeader h;
+    uint64_t length = 0;
+    bool ok = FileLength(file, length) &&
+              fread(&h, sizeof(h), 1, file) == 1 &&
+              memcmp(h.magic, streamFileMagic, 4) == 0 &&
+              h.version == streamFileVersion &&
+              h.platformStride == sizeof(Platform) &&
+              h.fileSize == length &&
+              h.basePlatformCount > 0 && h.chunkSize > 0.0f &&
+              SectionFits(length, h.basePlatformsOffset, (uint64_t)h.basePlatformCount * sizeof(Platform)) &&
+              SectionFits(length, h.chunkTableOffset, (uint64_t)h.chunkCount * sizeof(StreamChunkEntry));
+    if (ok) {
+        stream.base.resize(h.basePlatformCount);
+        stream.table.resize(h.chunkCount);
+        ok = SeekTo(file, h.basePlatformsOffset) &&
+             fread(stream.base.data(), sizeof(Platform), h.basePlatformCount, file) == h.basePlatformCount &&
+             SeekTo(file, h.chunkTableOffset) &&
+             fread(stream.table.data(), sizeof(StreamChunkEntry), h.chunkCount, file) == h.chunkCount;
+    }
+    for (uint32_t i = 0; ok && i < h.chunkCount; ++i) {
+        const StreamChunkEntry& e = stream.table[i];
+        ok = SectionFits(length, e.offset, (uint64_t)e.platformCount * sizeof(Platform));
+    }
+    if (!ok) {
+        TraceLog(LOG_WARNING, "STREAM: %s is not a compatible streamed level", path);
+        fclose(file);
+        stream.base.clear();
+        stream.table.clear();
+        return false;
+    }
+
+    stream.header = h;
+    stream.file   = file;
+    stream.chunkIndex.clear();
+    for (uint32_t i = 0; i < h.chunkCount; ++i)
+        stream.chunkIndex[ChunkKey(stream.table[i].chunkX, stream.table[i].chunkZ)] = i;
+    stream.loads   = 0;
+    stream.unloads = 0;
+    stream.window  = {};
+    stream.active  = true;
+
+    if (!stream.synchronous) {
+        stream.syncFile = fopen(path, "rb");
+        if (!stream.syncFile) {
+            TraceLog(LOG_WARNING, "STREAM: Could not reopen %s for the loader thread", path);
+            StreamClose();
+            return false;
+        }
+        worker.quit = false;
+        worker.thread = std::thread(WorkerLoop);
+    }
+    return true;
+}
+
+void StreamClose() {
+    if (worker.thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.quit = true;
+        }
+        worker.wake.notify_all();
+        worker.thread.join();
+    }
+    worker.requests.clear();
+    worker.done.clear();
+
+    if (stream.file) fclose(stream.file);
+    if (stream.syncFile) fclose(stream.syncFile);
+    stream.file     = nullptr;
+    stream.syncFile = nullptr;
+    stream.base.clear();
+    stream.table.clear();
+    stream.chunkIndex.clear();
+    stream.resident.clear();
+    stream.pending.clear();
+    stream.active = false;
+}
+
+bool StreamActive() {
+    return stream.active;
+}
+
+void StreamSetRadius(float meters) {
+    stream.radius = std::max(0.0f, meters);
+}
+
+void StreamSetSynchronous(bool synchronous) {
+    stream.synchronous = synchronous;   // takes effect at the next StreamOpen()
+}
+
+// -----------------------------------------------------------------------------
+// Residency
+// -----------------------------------------------------------------------------
+// Distance from (x, z) to the nearest point of a chunk's square
+static float ChunkDistance(int32_t cx, int32_t cz, float x, float z, float chunkSize) {
+    const float minX = cx * chunkSize, minZ = cz * chunkSize;
+    const float dx = std::max({ minX - x, 0.0f, x - (minX + chunkSize) });
+    const float dz = std::max({ minZ - z, 0.0f, z - (minZ + chunkSize) });
+    return sqrtf(dx*dx + dz*dz);
+}
+
+bool StreamUpdate(float x, float z, bool wait) {
+    if (!stream.active) return false;
+
+    const float size = stream.header.chunkSize;
+    const float loadRadius   = stream.radius;
+    const float unloadRadius = stream.radius + size * 0.5f;   // hysteresis at the edge
+    bool changed = false;
+
+    // Drop far chunks; loads still in flight are filtered when they arrive
+    for (auto it = stream.resident.begin(); it != stream.resident.end();) {
+        if (ChunkDistance(ChunkX(it->first), ChunkZ(it->first), x, z, size) > unloadRadius) {
+            it = stream.resident.erase(it);
+            stream.unloads++;
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    const int32_t c0x = ChunkCoord(x - loadRadius, size), c1x = ChunkCoord(x + loadRadius, size);
+    const int32_t c0z = ChunkCoord(z - loadRadius, size), c1z = ChunkCoord(z + loadRadius, size);
+    const XZBounds window = { c0x * size, c0z * size, (c1x + 1) * size, (c1z + 1) * size };
+    if (memcmp(&window, &stream.window, sizeof(window)) != 0) {
+        stream.window = window;
+        changed = true;
+    }
+
+    // Wanted chunks that exist in the file and aren't resident yet. A blocking
+    // update also reads chunks already queued; their late copies are ignored.
+    const bool blocking = stream.synchronous || wait;
+    stream.wanted.clear();
+    for (int32_t cz = c0z; cz <= c1z; ++cz) {
+        for (int32_t cx = c0x; cx <= c1x; ++cx) {
+            const uint64_t key = ChunkKey(cx, cz);
+            if (ChunkDistance(cx, cz, x, z, size) > loadRadius) continue;
+            if (stream.resident.count(key)) continue;
+            if (!blocking && stream.pending.count(key)) continue;
+            if (!stream.chunkIndex.count(key)) continue;   // nothing in this chunk
+            stream.wanted.push_back(key);
+        }
+    }
+
+    if (!stream.wanted.empty()) AllocGuardMarkUnsteady();   // requests and map nodes
+    if (blocking) {
+        FILE* file = stream.synchronous ? stream.file : stream.syncFile;
+        for (uint64_t key : stream.wanted) {
+            std::vector<Platform>& platforms = stream.resident[key];
+            if (!ReadChunk(file, stream.table[stream.chunkIndex[key]], platforms))
+                platforms.clear();
+            stream.loads++;
+            changed = true;
+        }
+    } else if (!stream.wanted.empty()) {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        for (uint64_t key : stream.wanted) {
+            worker.requests.push_back(stream.chunkIndex[key]);
+            stream.pending.insert(key);
+        }
+        worker.wake.notify_one();
+    }
+
+    // Take finished loads; ones that fell out of range meanwhile are discarded
+    if (!stream.pending.empty()) {
+        AllocGuardMarkUnsteady();
+        std::vector<LoadedChunk> done;
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            done.swap(worker.done);
+        }
+        for (LoadedChunk& chunk : done) {
+            if (!stream.pending.erase(chunk.key)) continue;
+            if (ChunkDistance(ChunkX(chunk.key), ChunkZ(chunk.key), x, z, size) > unloadRadius) continue;
+            if (stream.resident.count(chunk.key)) continue;   // a blocking load got there first
+            stream.resident[chunk.key] = std::move(chunk.platforms);
+            stream.loads++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void StreamGatherResident(std::vector<Platform>& platforms, XZBounds& area) {
+    platforms.assign(stream.base.begin(), stream.base.end());
+
+    // The load window, grown to cover chunks kept by the unload hysteresis
+    const float size = stream.header.chunkSize;
+    area = stream.window;
+    for (const auto& c : stream.resident) {
+        platforms.insert(platforms.end(), c.second.begin(), c.second.end());
+        const float minX = ChunkX(c.first) * size, minZ = ChunkZ(c.first) * size;
+        area.minX = std::min(area.minX, minX);        area.minZ = std::min(area.minZ, minZ);
+        area.maxX = std::max(area.maxX, minX + size); area.maxZ = std::max(area.maxZ, minZ + size);
+    }
+}
+
+const Platform& StreamFloor() {
+    return stream.base[0];
+}
+
+StreamStats StreamGetStats() {
+    size_t platforms = stream.base.size();
+    for (const auto& c : stream.resident) platforms += c.second.size();
+    return { (int)stream.resident.size(), (int)stream.pending.size(), stream.loads, stream.unloads, platforms };
+}
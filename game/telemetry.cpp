@@ -0,0 +1,244 @@
+#include "telemetry.h"
+#include "spscring.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Kept clear of raylib.h, whose names collide with the Windows headers
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #if defined(_MSC_VER)
+        #pragma comment(lib, "ws2_32.lib")
+    #endif
+    using SocketHandle = SOCKET;
+    static const SocketHandle noSocket = INVALID_SOCKET;
+    static void CloseSocket(SocketHandle s) { closesocket(s); }
+#else
+    #include <netdb.h>
+    #include <sys/socket.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+    using SocketHandle = int;
+    static const SocketHandle noSocket = -1;
+    static void CloseSocket(SocketHandle s) { close(s); }
+#endif
+
+enum TelemetryFormat {
+    TELEMETRY_JSON = 0,
+    TELEMETRY_CSV
+};
+
+struct TelemetrySink {
+    SpscRing<TelemetrySample, telemetryRingCapacity> ring;
+    std::atomic<bool>     active{ false };
+    std::atomic<uint64_t> submitted{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::chrono::steady_clock::time_point opened;
+
+    // Writer thread
+    std::thread thread;
+    std::mutex  mutex;                  // guards quit, for the timed wait only
+    std::condition_variable wake;
+    bool        quit;
+    FILE*       file;
+    SocketHandle socket;
+    sockaddr_storage address;
+    int         addressLength;
+    TelemetryFormat format;
+    std::string buffer;                 // the sample being written, reused
+};
+
+static TelemetrySink sink;
+
+// Builds with the profiler compiled out have no phase timings to write
+constexpr int writtenPhases = LIX_PROFILING ? telemetryPhaseCount : 0;
+
+// -----------------------------------------------------------------------------
+// Formatting
+// -----------------------------------------------------------------------------
+static void AppendCsvHeader(std::string& out) {
+    out += "tick,seconds,health,enemies_defeated,shots_fired,shots_hit,survival_time,wave,"
+           "enemies,rounds,tick_ms,tick_ms_max,allocations";
+    for (int p = 0; p < writtenPhases; ++p) {
+        out += ",phase_";
+        for (const char* c = ProfilerPhaseName((ProfilePhase)(telemetryFirstPhase + p)); *c; ++c)
+            out += (*c == ' ') ? '_' : (char)(*c | 0x20);
+    }
+    out += '\n';
+}
+
+static void AppendSample(std::string& out, const TelemetrySample& s, TelemetryFormat format) {
+    char line[1024];
+    int n;
+    if (format == TELEMETRY_CSV) {
+        n = snprintf(line, sizeof(line), "%llu,%.3f,%d,%d,%d,%d,%.2f,%d,%u,%u,%.4f,%.4f,%llu",
+                     (unsigned long long)s.tick, s.seconds, s.health, s.enemiesDefeated, s.shotsFired,
+                     s.shotsHit, s.survivalTime, s.wave, s.enemies, s.rounds, s.tickMs, s.tickMsMax,
+                     (unsigned long long)s.allocations);
+        for (int p = 0; p < writtenPhases && n < (int)sizeof(line); ++p)
+            n += snprintf(line + n, sizeof(line) - n, ",%.4f", s.phaseMs[p]);
+    } else {
+        n = snprintf(line, sizeof(line),
+                     "{\"tick\":%llu,\"seconds\":%.3f,\"health\":%d,\"enemies_defeated\":%d,"
+                     "\"shots_fired\":%d,\"shots_hit\":%d,\"survival_time\":%.2f,\"wave\":%d,"
+                     "\"enemies\":%u,\"rounds\":%u,\"tick_ms\":%.4f,\"tick_ms_max\":%.4f,"
+                     "\"allocations\":%llu,\"phases\":{",
+                     (unsigned long long)s.tick, s.seconds, s.health, s.enemiesDefeated, s.shotsFired,
+                     s.shotsHit, s.survivalTime, s.wave, s.enemies, s.rounds, s.tickMs, s.tickMsMax,
+                     (unsigned long long)s.allocations);
+        for (int p = 0; p < writtenPhases && n < (int)sizeof(line); ++p)
+            n += snprintf(line + n, sizeof(line) - n, "%s\"%s\":%.4f", p ? "," : "",
+                          ProfilerPhaseName((ProfilePhase)(telemetryFirstPhase + p)), s.phaseMs[p]);
+        if (n < (int)sizeof(line)) n += snprintf(line + n, sizeof(line) - n, "}}");
+    }
+    if (n >= (int)sizeof(line)) n = (int)sizeof(line) - 1;
+    out.append(line, (size_t)n);
+    out += '\n';
+}
+
+// -----------------------------------------------------------------------------
+// Writer thread
+// -----------------------------------------------------------------------------
+static void Flush() {
+    TelemetrySample sample;
+    while (sink.ring.Pop(sample)) {
+        sink.buffer.clear();
+        AppendSample(sink.buffer, sample, sink.format);
+        if (sink.socket != noSocket) {
+            // One datagram per sample; a lost one is just a gap in the series
+            sendto(sink.socket, sink.buffer.data(), (int)sink.buffer.size(), 0,
+                   (const sockaddr*)&sink.address, sink.addressLength);
+        } else {
+            fwrite(sink.buffer.data(), 1, sink.buffer.size(), sink.file);
+        }
+        sink.written.fetch_add(1, std::memory_order_relaxed);
+        sink.bytes.fetch_add(sink.buffer.size(), std::memory_order_relaxed);
+    }
+    if (sink.file) fflush(sink.file);
+}
+
+static void WriterLoop() {
+    std::unique_lock<std::mutex> lock(sink.mutex);
+    while (!sink.quit) {
+        sink.wake.wait_for(lock, std::chrono::milliseconds(telemetryFlushMs), [] { return sink.quit; });
+        lock.unlock();
+        Flush();
+        lock.lock();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Lifecycle
+// -----------------------------------------------------------------------------
+static bool OpenUdp(const char* hostPort) {
+    char host[256];
+    const char* colon = strrchr(hostPort, ':');
+    if (!colon || colon == hostPort || (size_t)(colon - hostPort) >= sizeof(host)) return false;
+    memcpy(host, hostPort, (size_t)(colon - hostPort));
+    host[colon - hostPort] = '\0';
+
+#if defined(_WIN32)
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    addrinfo hints = {};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host, colon + 1, &hints, &found) != 0 || !found) {
+#if defined(_WIN32)
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    sink.socket = ::socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+    if (sink.socket != noSocket) {
+        memcpy(&sink.address, found->ai_addr, found->ai_addrlen);
+        sink.addressLength = (int)found->ai_addrlen;
+    }
+    freeaddrinfo(found);
+#if defined(_WIN32)
+    if (sink.socket == noSocket) WSACleanup();
+#endif
+    return sink.socket != noSocket;
+}
+
+bool TelemetryOpen(const char* target) {
+    if (sink.active) TelemetryClose();
+    sink.file   = nullptr;
+    sink.socket = noSocket;
+    sink.format = TELEMETRY_JSON;
+
+    if (strncmp(target, "udp://", 6) == 0) {
+        if (!OpenUdp(target + 6)) return false;
+    } else {
+        sink.file = fopen(target, "w");
+        if (!sink.file) return false;
+        const size_t len = strlen(target);
+        if (len >= 4 && strcmp(target + len - 4, ".csv") == 0) {
+            sink.format = TELEMETRY_CSV;
+            sink.buffer.clear();
+            AppendCsvHeader(sink.buffer);
+            fwrite(sink.buffer.data(), 1, sink.buffer.size(), sink.file);
+        }
+    }
+
+    sink.submitted = sink.dropped = sink.written = sink.bytes = 0;
+    sink.opened = std::chrono::steady_clock::now();
+    sink.quit   = false;
+    sink.thread = std::thread(WriterLoop);
+    sink.active = true;
+    return true;
+}
+
+void TelemetryClose() {
+    if (!sink.active) return;
+    sink.active = false;
+    {
+        std::lock_guard<std::mutex> lock(sink.mutex);
+        sink.quit = true;
+    }
+    sink.wake.notify_all();
+    sink.thread.join();
+    Flush();   // anything pushed after the writer's last pass
+
+    if (sink.file) fclose(sink.file);
+    if (sink.socket != noSocket) {
+        CloseSocket(sink.socket);
+#if defined(_WIN32)
+        WSACleanup();
+#endif
+    }
+    sink.file   = nullptr;
+    sink.socket = noSocket;
+}
+
+bool TelemetryActive() {
+    // Acquire: a producer that sees active also sees what TelemetryOpen set before it
+    return sink.active.load(std::memory_order_acquire);
+}
+
+void TelemetrySubmit(const TelemetrySample& sample) {
+    if (!TelemetryActive()) return;
+    TelemetrySample stamped = sample;
+    stamped.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sink.opened).count();
+    sink.submitted.fetch_add(1, std::memory_order_relaxed);
+    if (!sink.ring.Push(stamped))
+        sink.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+TelemetryStats GetTelemetryStats() {
+    return { sink.submitted.load(std::memory_order_relaxed), sink.dropped.load(std::memory_order_relaxed),
+             sink.written.load(std::memory_order_relaxed), sink.bytes.load(std::memory_order_relaxed) };
+}
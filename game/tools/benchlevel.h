@@ -0,0 +1,35 @@
+#pragma once
+// Level setup shared by the headless runner and the microbenchmarks
+#include "game.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Scatters extra crates over the current arena's floor, clear of the player's
+// spawn point, then resets the arena onto the new platform set
+inline void AddBenchmarkPlatforms(int count, uint32_t seed, float floorSize) {
+    const World& world = CurrentWorld();
+    if (world.platforms.empty() || (count <= 0 && floorSize <= 0.0f)) return;
+
+    std::mt19937 rng{ seed ^ 0x9e3779b9u };
+    std::vector<Platform> platforms(world.platforms.begin(), world.platforms.end());
+    if (floorSize > 0.0f) {
+        platforms[0].size.x = floorSize;
+        platforms[0].size.z = floorSize;
+    }
+    const Platform floor = platforms[0];
+    const float halfX = floor.size.x * 0.5f - 2.0f;
+    const float halfZ = floor.size.z * 0.5f - 2.0f;
+    const float topY  = floor.position.y + floor.size.y * 0.5f;
+    std::uniform_real_distribution<float> px(-halfX, halfX), pz(-halfZ, halfZ), size(0.5f, 3.0f);
+
+    platforms.reserve(platforms.size() + count);
+    while (count > 0) {
+        const Vector3 s = { size(rng), size(rng), size(rng) };
+        const Vector3 p = { floor.position.x + px(rng), topY + s.y * 0.5f, floor.position.z + pz(rng) };
+        if (fabsf(p.x - floor.position.x) < 3.0f && fabsf(p.z - floor.position.z) < 3.0f) continue;
+        platforms.push_back({ p, s, GRAY });
+        --count;
+    }
+    GameSetPlatforms(std::move(platforms));
+}
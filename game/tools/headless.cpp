@@ -0,0 +1,510 @@
+// Headless simulation runner: steps GameTick() at a fixed dt from scripted input
+// with no window, then reports throughput and per-phase timings. Used as the
+// regression benchmark. With --arenas N it runs N independent matches on a
+// pool of threads instead, the way a server would host them.
+#include "game.h"
+#include "input.h"
+#include "jobs.h"
+#include "arena.h"
+#include "profiler.h"
+#include "replay.h"
+#include "savestate.h"
+#include "telemetry.h"
+#include "benchlevel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+struct HeadlessOptions {
+    int ticks         = 3600;
+    int hz            = 60;
+    int enemies       = 0;
+    int platforms     = 0;
+    uint32_t seed     = 1;
+    const char* script = nullptr;
+    const char* level  = nullptr;
+    const char* compileLevel = nullptr;   // write the benchmark level here and exit
+    const char* compileStreamed = nullptr;
+    float floorSize   = 0.0f;    // > 0 resizes the floor before crates are scattered
+    float streamRadius = streamDefaultRadius;
+    bool mortal       = false;   // default keeps the player alive so load stays constant
+    int threads       = 0;       // job (or, with arenas, pool) threads including this one; 0 = hardware
+    int arenas        = 1;       // independent matches, each seeded seed + index
+    bool hitscan      = false;   // fire rays instead of simulated rounds
+    const char* record = nullptr;   // write the session as a replay
+    const char* replay = nullptr;   // re-simulate a replay instead of running a script
+    int checksumEvery = replayDefaultChecksumInterval;
+    int rollbackEvery = 0;       // > 0: save, encode, decode and restore the state this often
+    const char* telemetry = nullptr;   // stream samples to a file or udp://host:port
+};
+
+static void PrintUsage() {
+    printf("usage: headless [--ticks N] [--hz N] [--enemies N] [--platforms N]\n"
+           "                [--seed N] [--script FILE] [--mortal] [--threads N]\n"
+           "                [--level FILE] [--compile-level OUT.lxl] [--compile-streamed OUT.lxs]\n"
+           "                [--floor-size M] [--stream-radius M] [--hitscan]\n"
+           "                [--record OUT.lxr] [--replay FILE.lxr] [--checksum-every N]\n"
+           "                [--rollback-every N] [--telemetry OUT.csv | OUT.jsonl | udp://HOST:PORT]\n"
+           "                [--arenas N]\n");
+}
+
+static bool ParseOptions(int argc, char** argv, HeadlessOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if      (!strcmp(arg, "--ticks")     && hasValue) opt.ticks     = atoi(argv[++i]);
+        else if (!strcmp(arg, "--hz")        && hasValue) opt.hz        = atoi(argv[++i]);
+        else if (!strcmp(arg, "--enemies")   && hasValue) opt.enemies   = atoi(argv[++i]);
+        else if (!strcmp(arg, "--platforms") && hasValue) opt.platforms = atoi(argv[++i]);
+        else if (!strcmp(arg, "--seed")      && hasValue) opt.seed      = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--script")    && hasValue) opt.script    = argv[++i];
+        else if (!strcmp(arg, "--level")     && hasValue) opt.level     = argv[++i];
+        else if (!strcmp(arg, "--compile-level") && hasValue) opt.compileLevel = argv[++i];
+        else if (!strcmp(arg, "--compile-streamed") && hasValue) opt.compileStreamed = argv[++i];
+        else if (!strcmp(arg, "--floor-size") && hasValue) opt.floorSize = (float)atof(argv[++i]);
+        else if (!strcmp(arg, "--stream-radius") && hasValue) opt.streamRadius = (float)atof(argv[++i]);
+        else if (!strcmp(arg, "--threads")   && hasValue) opt.threads   = atoi(argv[++i]);
+        else if (!strcmp(arg, "--mortal"))                opt.mortal    = true;
+        else if (!strcmp(arg, "--hitscan"))               opt.hitscan   = true;
+        else if (!strcmp(arg, "--record")    && hasValue) opt.record    = argv[++i];
+        else if (!strcmp(arg, "--replay")    && hasValue) opt.replay    = argv[++i];
+        else if (!strcmp(arg, "--checksum-every") && hasValue) opt.checksumEvery = atoi(argv[++i]);
+        else if (!strcmp(arg, "--rollback-every") && hasValue) opt.rollbackEvery = atoi(argv[++i]);
+        else if (!strcmp(arg, "--telemetry") && hasValue) opt.telemetry = argv[++i];
+        else if (!strcmp(arg, "--arenas")    && hasValue) opt.arenas    = atoi(argv[++i]);
+        else return false;
+    }
+    // Restoring a quantized state changes the run, so it can't be recorded or replayed
+    if (opt.rollbackEvery > 0 && (opt.record || opt.replay)) return false;
+    // Replays, save states, telemetry and the chunk streamer each cover one match
+    if (opt.arenas > 1 && (opt.record || opt.replay || opt.rollbackEvery > 0 || opt.telemetry ||
+                           (opt.level && IsStreamedLevel(opt.level))))
+        return false;
+    return opt.arenas > 0 && opt.ticks > 0 && opt.hz > 0 && opt.checksumEvery > 0 && opt.rollbackEvery >= 0;
+}
+
+// A replay carries its own setup; it replaces whatever the command line said
+static void ApplyReplaySetup(const ReplaySetup& setup, HeadlessOptions& opt) {
+    opt.hz        = setup.tickRate;
+    opt.seed      = setup.seed;
+    opt.enemies   = setup.fillEnemies;
+    opt.platforms = setup.benchmarkPlatforms;
+    opt.floorSize = setup.floorSize;
+    opt.mortal    = !setup.immortal;
+    opt.hitscan   = setup.weaponMode == WEAPON_HITSCAN;
+    opt.level     = setup.level[0] ? setup.level : nullptr;
+    GameSetEnemyLimit(setup.enemyLimit);
+}
+
+static void FillEnemies(int count) {
+    SpawnEnemies(count - (int)CurrentWorld().enemies.size());
+}
+
+// Seeds and builds the calling thread's current arena as the options describe
+static bool SetUpArena(const HeadlessOptions& opt, uint32_t seed) {
+    GameSeedRandom(seed);
+    if (opt.enemies > 0)
+        GameSetEnemyLimit(opt.enemies);
+    GameSetWeaponMode(opt.hitscan ? WEAPON_HITSCAN : WEAPON_PROJECTILE);
+    GameReset();
+    if (opt.level && !GameLoadLevel(opt.level)) {
+        fprintf(stderr, "headless: could not load level '%s'\n", opt.level);
+        return false;
+    }
+    AddBenchmarkPlatforms(opt.platforms, opt.seed, opt.floorSize);
+    return true;
+}
+
+struct PhaseTrack {
+    std::vector<float> samples;
+};
+
+static void Report(const char* name, std::vector<float>& v) {
+    if (v.empty()) return;
+    double sum = 0.0;
+    for (float x : v) sum += x;
+    std::sort(v.begin(), v.end());
+    const size_t p99 = std::min(v.size() - 1, (size_t)(v.size() * 0.99));
+    printf("  %-12s %9.4f %9.4f %9.4f\n", name, sum / v.size(), v[p99], v.back());
+}
+
+// Exercises the rollback path: the state is captured and encoded in full and as
+// a delta against the previous capture; both must decode to it exactly, and
+// restoring it must capture back to the same state.
+struct RollbackCheck {
+    SaveState previous, current, decoded, restored;
+    std::vector<uint8_t> bytes;
+    uint64_t captures;
+    uint64_t fullBytes;
+    uint64_t deltaBytes;
+    uint64_t deltas;
+    double   encodeMs;
+};
+
+static bool RunRollbackCheck(RollbackCheck& check, uint64_t tick) {
+    GameCaptureState(check.current, tick);
+
+    const auto start = std::chrono::steady_clock::now();
+    check.bytes.clear();
+    EncodeSaveState(check.current, nullptr, check.bytes);
+    check.encodeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    check.fullBytes += check.bytes.size();
+    if (!DecodeSaveState(check.bytes.data(), check.bytes.size(), nullptr, check.decoded) ||
+        !SaveStatesEqual(check.decoded, check.current))
+        return false;
+
+    if (check.captures > 0) {
+        check.bytes.clear();
+        EncodeSaveState(check.current, &check.previous, check.bytes);
+        check.deltaBytes += check.bytes.size();
+        check.deltas++;
+        if (!DecodeSaveState(check.bytes.data(), check.bytes.size(), &check.previous, check.decoded) ||
+            !SaveStatesEqual(check.decoded, check.current))
+            return false;
+    }
+    check.captures++;
+
+    if (!GameRestoreState(check.decoded)) return false;
+    GameCaptureState(check.restored, tick);
+    std::swap(check.previous, check.current);
+    return SaveStatesEqual(check.restored, check.previous);
+}
+
+// -----------------------------------------------------------------------------
+// Arena mode
+// -----------------------------------------------------------------------------
+// Each arena is a whole match with its own seed and copy of the script. Pool
+// threads claim arenas one at a time and run each for all its ticks, so an
+// arena never changes threads mid-run. Jobs inside a tick run inline; the
+// parallelism is across arenas.
+struct ArenaRun {
+    GameArena*  arena;
+    InputScript script;
+    int         restarts;
+};
+
+struct ArenaWorker {
+    PhaseTrack phases[PHASE_COUNT];
+    std::vector<float> tickMs;
+    int allocatingTicks;
+};
+
+static void RunArena(const HeadlessOptions& opt, ArenaRun& run, ArenaWorker& worker) {
+    const float dt = 1.0f / (float)opt.hz;
+    GameBindArena(run.arena);
+    for (int t = 0; t < opt.ticks; ++t) {
+        const TickInput input = NextScriptedInput(run.script);
+
+        ArenaReset(frameArena);
+        AllocGuardBeginFrame();
+        const auto tickStart = std::chrono::steady_clock::now();
+
+        if (!opt.mortal) CurrentPlayer().health = 100;
+        GameTick(dt, input);
+
+        const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - tickStart).count();
+        if (AllocGuardEndFrame() > 0) ++worker.allocatingTicks;
+
+        float phaseMs[PHASE_COUNT];
+        ProfilerTakeThreadTotals(phaseMs);
+        worker.tickMs.push_back(ms);
+        for (int p = 0; p < PHASE_COUNT; ++p)
+            worker.phases[p].samples.push_back(phaseMs[p]);
+
+        if (opt.mortal && GameIsOver()) {
+            ++run.restarts;
+            GameReset();
+            FillEnemies(opt.enemies);
+        }
+    }
+    GameBindArena(nullptr);
+}
+
+static int RunArenas(const HeadlessOptions& opt, const InputScript& script) {
+    JobsInit(1);
+    ArenaInit(frameArena);
+
+    // Arena 0 is the main one, already set up by the caller
+    std::vector<ArenaRun> runs((size_t)opt.arenas);
+    for (int i = 0; i < opt.arenas; ++i) {
+        ArenaRun& run = runs[(size_t)i];
+        run.arena = i == 0 ? &CurrentArena() : GameCreateArena(opt.seed + (uint32_t)i);
+        run.script = script;
+        run.restarts = 0;
+        GameBindArena(run.arena);
+        if (i > 0 && !SetUpArena(opt, opt.seed + (uint32_t)i)) return 1;
+        FillEnemies(opt.enemies);
+    }
+    GameBindArena(nullptr);
+
+    const int hardware = std::max(1, (int)std::thread::hardware_concurrency());
+    const int threads = std::min(opt.threads > 0 ? opt.threads : hardware, opt.arenas);
+    std::vector<ArenaWorker> workers((size_t)threads);
+    // Each thread only grows its own vectors, which would count against the alloc guard
+    const size_t perThread = (size_t)opt.ticks * (size_t)((opt.arenas + threads - 1) / threads);
+    for (ArenaWorker& w : workers) {
+        w.tickMs.reserve(perThread);
+        for (auto& p : w.phases) p.samples.reserve(perThread);
+        w.allocatingTicks = 0;
+    }
+
+    std::atomic<int> nextArena{ 0 };
+    auto work = [&](int index) {
+        for (int i; (i = nextArena.fetch_add(1, std::memory_order_relaxed)) < opt.arenas;)
+            RunArena(opt, runs[(size_t)i], workers[(size_t)index]);
+    };
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back([&, t] {
+            ArenaInit(frameArena);
+            work(t);
+            ArenaShutdown(frameArena);
+        });
+    work(0);
+    for (std::thread& t : pool) t.join();
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Merge the per-thread samples; order doesn't matter past here
+    ArenaWorker all = {};
+    int restarts = 0, shotsFired = 0, shotsHit = 0;
+    for (ArenaWorker& w : workers) {
+        all.tickMs.insert(all.tickMs.end(), w.tickMs.begin(), w.tickMs.end());
+        for (int p = 0; p < PHASE_COUNT; ++p)
+            all.phases[p].samples.insert(all.phases[p].samples.end(),
+                                         w.phases[p].samples.begin(), w.phases[p].samples.end());
+        all.allocatingTicks += w.allocatingTicks;
+    }
+    for (const ArenaRun& run : runs) {
+        restarts   += run.restarts;
+        shotsFired += run.arena->player.shotsFired;
+        shotsHit   += run.arena->player.shotsHit;
+    }
+
+    const double arenaTicks = (double)opt.arenas * opt.ticks;
+    const int cores = std::min(threads, hardware);
+    const float dt = 1.0f / (float)opt.hz;
+    printf("arenas %d x %d ticks @ %d Hz | enemies %d | platforms %zu | seeds %u-%u | threads %d | restarts %d\n",
+           opt.arenas, opt.ticks, opt.hz, opt.enemies, CurrentWorld().platforms.size(), opt.seed,
+           opt.seed + (uint32_t)opt.arenas - 1, threads, restarts);
+    printf("wall %.3f s | %.1f arena-ticks/sec | %.1f per core | %.1fx real time per arena\n",
+           wall, arenaTicks / wall, arenaTicks / wall / cores, (opt.ticks * dt) / wall);
+    printf("weapon %s | shots %d fired, %d hit (all arenas, since last restart)\n",
+           opt.hitscan ? "hitscan" : "rounds", shotsFired, shotsHit);
+#if defined(LIX_ALLOC_TRACKING)
+    printf("alloc: %d steady-state arena-ticks allocated\n", all.allocatingTicks);
+#endif
+    printf("  %-12s %9s %9s %9s\n", "phase (ms)", "avg", "p99", "max");
+    for (int p = PHASE_INPUT; p < PHASE_DRAW_WORLD; ++p)
+        Report(ProfilerPhaseName((ProfilePhase)p), all.phases[p].samples);
+    Report("tick", all.tickMs);
+
+    for (size_t i = 1; i < runs.size(); ++i) GameDestroyArena(runs[i].arena);
+    JobsShutdown();
+    StreamClose();
+    ArenaShutdown(frameArena);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    HeadlessOptions opt;
+    if (!ParseOptions(argc, argv, opt)) {
+        PrintUsage();
+        return 1;
+    }
+
+    // The reader owns the setup strings opt points into, so it outlives the run
+    ReplayReader replay;
+    if (opt.replay) {
+        if (!LoadReplay(replay, opt.replay)) {
+            fprintf(stderr, "headless: could not read replay '%s'\n", opt.replay);
+            return 1;
+        }
+        ApplyReplaySetup(replay.setup, opt);
+    }
+
+    InputScript script;
+    if (opt.script) {
+        if (!LoadInputScript(script, opt.script)) {
+            fprintf(stderr, "headless: could not read script '%s'\n", opt.script);
+            return 1;
+        }
+    } else {
+        MakeDefaultInputScript(script);
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    StreamSetSynchronous(true);   // chunk loads land on the same tick every run
+    StreamSetRadius(opt.streamRadius);
+    GameSetTickRate(opt.hz);
+    if (!SetUpArena(opt, opt.seed)) return 1;
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
+
+    if (opt.compileLevel) {
+        if (!WriteCompiledLevel(opt.compileLevel, world.platforms.data(), world.platforms.size())) {
+            fprintf(stderr, "headless: could not write '%s'\n", opt.compileLevel);
+            return 1;
+        }
+        printf("wrote %s (%zu platforms)\n", opt.compileLevel, world.platforms.size());
+        return 0;
+    }
+    if (opt.compileStreamed) {
+        if (!WriteStreamedLevel(opt.compileStreamed, world.platforms.data(), world.platforms.size())) {
+            fprintf(stderr, "headless: could not write '%s'\n", opt.compileStreamed);
+            return 1;
+        }
+        printf("wrote %s (%zu platforms)\n", opt.compileStreamed, world.platforms.size());
+        return 0;
+    }
+    if (opt.arenas > 1) return RunArenas(opt, script);
+
+    JobsInit(opt.threads);
+    ArenaInit(frameArena);
+    FillEnemies(opt.enemies);
+
+    ReplayWriter recorder = {};
+    if (opt.record) {
+        ReplaySetup setup = {};
+        setup.seed               = opt.seed;
+        setup.tickRate           = opt.hz;
+        setup.enemyLimit         = GameGetEnemyLimit();
+        setup.weaponMode         = GameGetWeaponMode();
+        setup.checksumInterval   = opt.checksumEvery;
+        setup.benchmarkPlatforms = opt.platforms;
+        setup.floorSize          = opt.floorSize;
+        setup.fillEnemies        = opt.enemies;
+        setup.immortal           = !opt.mortal;
+        snprintf(setup.level, sizeof(setup.level), "%s", opt.level ? opt.level : "");
+        if (!ReplayBeginRecording(recorder, opt.record, setup)) {
+            fprintf(stderr, "headless: could not write '%s'\n", opt.record);
+            return 1;
+        }
+    }
+
+    if (opt.telemetry && !TelemetryOpen(opt.telemetry)) {
+        fprintf(stderr, "headless: could not open telemetry target '%s'\n", opt.telemetry);
+        return 1;
+    }
+
+    const float dt = 1.0f / (float)opt.hz;
+    PhaseTrack phases[PHASE_COUNT];
+    std::vector<float> tickMs;
+    tickMs.reserve(opt.ticks);
+    for (auto& p : phases) p.samples.reserve(opt.ticks);
+
+    RollbackCheck rollback = {};
+    int restarts = 0;
+    int allocatingTicks = 0;   // steady-state ticks that hit the heap (tracking builds)
+    int ticksRun = 0;
+    bool restartPending = false;
+    const auto start = std::chrono::steady_clock::now();
+    // A replay runs to its end; restarts come from the recording, not GameIsOver()
+    for (; opt.replay || ticksRun < opt.ticks; ++ticksRun) {
+        TickInput input;
+        if (opt.replay) {
+            bool restarted;
+            if (!NextReplayTick(replay, input, restarted)) break;
+            if (restarted) {
+                ++restarts;
+                GameReset();
+                FillEnemies(opt.enemies);
+            }
+        } else {
+            input = NextScriptedInput(script);
+        }
+
+        ArenaReset(frameArena);
+        AllocGuardBeginFrame();
+        ProfilerBeginFrame();
+        const auto tickStart = std::chrono::steady_clock::now();
+
+        if (!opt.mortal) player.health = 100;
+        ReplayRecordTick(recorder, input, restartPending);
+        restartPending = false;
+        GameTick(dt, input);
+
+        const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - tickStart).count();
+        if (AllocGuardEndFrame() > 0) ++allocatingTicks;
+
+        // After the guard: a replay's length isn't known up front, so these may grow
+        tickMs.push_back(ms);
+        for (int p = 0; p < PHASE_COUNT; ++p)
+            phases[p].samples.push_back(profiler.currentNs[p].load(std::memory_order_relaxed) * 1e-6f);
+
+        if (ReplayChecksumDue(recorder))
+            ReplayRecordChecksum(recorder, GameStateChecksum());
+        if (opt.replay && ReplayChecksumPending(replay)) {
+            const uint64_t checksum = GameStateChecksum();
+            uint64_t expected;
+            if (!VerifyReplayChecksum(replay, checksum, expected)) {
+                fprintf(stderr, "replay: diverged at tick %d (expected %016llx, got %016llx)\n",
+                        ticksRun + 1, (unsigned long long)expected, (unsigned long long)checksum);
+                return 2;
+            }
+        }
+
+        if (opt.rollbackEvery > 0 && (ticksRun + 1) % opt.rollbackEvery == 0 &&
+            !RunRollbackCheck(rollback, (uint64_t)ticksRun + 1)) {
+            fprintf(stderr, "savestate: round trip failed at tick %d\n", ticksRun + 1);
+            return 2;
+        }
+
+        if (!opt.replay && opt.mortal && GameIsOver()) {
+            ++restarts;
+            GameReset();
+            FillEnemies(opt.enemies);
+            restartPending = true;
+        }
+    }
+    ReplayEndRecording(recorder);
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TelemetryClose();
+
+    printf("ticks %d @ %d Hz | enemies %d | platforms %zu | seed %u | threads %d | restarts %d\n",
+           ticksRun, opt.hz, opt.enemies, world.platforms.size(), opt.seed, JobsThreadCount(), restarts);
+    printf("wall %.3f s | %.1f ticks/sec | %.1fx real time\n",
+           wall, ticksRun / wall, (ticksRun * dt) / wall);
+    if (opt.replay)
+        printf("replay: %llu ticks re-simulated, %llu checksums verified\n",
+               (unsigned long long)replay.ticks, (unsigned long long)replay.checksumsVerified);
+    if (opt.record)
+        printf("recorded %s\n", opt.record);
+    if (opt.telemetry) {
+        const TelemetryStats ts = GetTelemetryStats();
+        printf("telemetry: %llu samples | %llu dropped | %llu written | %llu B\n",
+               (unsigned long long)ts.submitted, (unsigned long long)ts.dropped,
+               (unsigned long long)ts.written, (unsigned long long)ts.bytes);
+    }
+    if (rollback.captures > 0)
+        printf("savestate: %llu restores | full %.0f B | delta %.0f B | encode %.3f ms\n",
+               (unsigned long long)rollback.captures, (double)rollback.fullBytes / rollback.captures,
+               rollback.deltas ? (double)rollback.deltaBytes / rollback.deltas : 0.0,
+               rollback.encodeMs / rollback.captures);
+    printf("weapon %s | shots %d fired, %d hit (since last restart)\n",
+           opt.hitscan ? "hitscan" : "rounds", player.shotsFired, player.shotsHit);
+#if defined(LIX_ALLOC_TRACKING)
+    printf("alloc: %d steady-state ticks allocated | arena peak %zu KB\n",
+           allocatingTicks, frameArena.peak / 1024);
+#endif
+    if (StreamActive()) {
+        const StreamStats ss = StreamGetStats();
+        printf("stream: %d chunks resident | %llu loads | %llu unloads | player at %.1f, %.1f\n",
+               ss.residentChunks, (unsigned long long)ss.loads, (unsigned long long)ss.unloads,
+               player.position.x, player.position.z);
+    }
+    printf("  %-12s %9s %9s %9s\n", "phase (ms)", "avg", "p99", "max");
+    for (int p = PHASE_INPUT; p < PHASE_DRAW_WORLD; ++p)
+        Report(ProfilerPhaseName((ProfilePhase)p), phases[p].samples);
+    Report("tick", tickMs);
+
+    JobsShutdown();
+    StreamClose();
+    ArenaShutdown(frameArena);
+    return 0;
+}
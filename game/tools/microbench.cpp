@@ -0,0 +1,482 @@
+// Microbenchmarks for the collision and update hot paths. Each case runs over a
+// grid of entity and platform counts and reports the median time per iteration.
+// --json writes the results in Google Benchmark's layout, so two runs can be
+// diffed with its tools/compare.py, or with plain diff since names and order
+// are stable.
+#include "game.h"
+#include "collision.h"
+#include "projectiles.h"
+#include "jobs.h"
+#include "arena.h"
+#include "benchlevel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct MicrobenchOptions {
+    const char* filter = nullptr;   // run only cases whose name contains this
+    const char* json   = nullptr;   // write results here, "-" for stdout
+    double minTime     = 0.25;      // seconds of timed work per repetition
+    int repetitions    = 3;
+    int threads        = 1;         // job threads for the update cases; 1 keeps runs comparable
+    bool list          = false;
+};
+
+static void PrintUsage() {
+    printf("usage: microbench [--filter TEXT] [--json OUT.json | -] [--min-time S]\n"
+           "                  [--repetitions N] [--threads N] [--list]\n");
+}
+
+static bool ParseOptions(int argc, char** argv, MicrobenchOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if      (!strcmp(arg, "--filter")      && hasValue) opt.filter      = argv[++i];
+        else if (!strcmp(arg, "--json")        && hasValue) opt.json        = argv[++i];
+        else if (!strcmp(arg, "--min-time")    && hasValue) opt.minTime     = atof(argv[++i]);
+        else if (!strcmp(arg, "--repetitions") && hasValue) opt.repetitions = atoi(argv[++i]);
+        else if (!strcmp(arg, "--threads")     && hasValue) opt.threads     = atoi(argv[++i]);
+        else if (!strcmp(arg, "--list"))                    opt.list        = true;
+        else return false;
+    }
+    return opt.minTime > 0.0 && opt.repetitions > 0 && opt.threads >= 0;
+}
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+using BenchClock = std::chrono::steady_clock;
+
+// Handed to a case, which sets up and then loops while KeepRunning(). Work
+// between Pause() and Resume(), such as refilling a pool, is not timed.
+struct BenchState {
+    int64_t iterations;            // to run in this pass
+    int64_t done;
+    int64_t items;                 // processed per iteration, set by the case
+    uint64_t sink;                 // results folded in so the work can't be optimized out
+    BenchClock::duration elapsed;
+    BenchClock::time_point resumed;
+
+    bool KeepRunning() {
+        if (done == 0) resumed = BenchClock::now();
+        if (done < iterations) {
+            ++done;
+            return true;
+        }
+        elapsed += BenchClock::now() - resumed;
+        return false;
+    }
+    void Pause()  { elapsed += BenchClock::now() - resumed; }
+    void Resume() { resumed = BenchClock::now(); }
+};
+
+using BenchFn = void (*)(BenchState& state, int entities, int platforms);
+
+// A case runs at every entities x platforms pair; an empty list drops that
+// argument from the case's name
+struct BenchCase {
+    const char*      name;
+    BenchFn          fn;
+    std::vector<int> entities;
+    std::vector<int> platforms;
+};
+
+struct BenchResult {
+    std::string name;
+    int64_t iterations;
+    int64_t items;
+    double  ns;                    // per iteration, median of the repetitions
+    double  nsMin;
+    double  nsMax;
+};
+
+static volatile uint64_t benchSink;
+
+static double RunPass(const BenchCase& c, int entities, int platforms, int64_t iterations, int64_t& items) {
+    BenchState state = {};
+    state.iterations = iterations;
+    state.items = 1;
+    c.fn(state, entities, platforms);
+    benchSink = benchSink + state.sink;
+    items = state.items;
+    return std::chrono::duration<double>(state.elapsed).count();
+}
+
+static BenchResult RunCase(const BenchCase& c, const std::string& name, int entities, int platforms,
+                           const MicrobenchOptions& opt) {
+    // Grow the pass until it is long enough to time, then size it to minTime
+    int64_t iterations = 1, items = 1;
+    double seconds = RunPass(c, entities, platforms, iterations, items);
+    while (seconds < opt.minTime * 0.1 && iterations < (int64_t)1 << 30) {
+        iterations *= 10;
+        seconds = RunPass(c, entities, platforms, iterations, items);
+    }
+    iterations = std::max<int64_t>(1, (int64_t)(iterations * opt.minTime / std::max(seconds, 1e-9)));
+
+    std::vector<double> ns;
+    for (int r = 0; r < opt.repetitions; ++r)
+        ns.push_back(RunPass(c, entities, platforms, iterations, items) * 1e9 / (double)iterations);
+    std::sort(ns.begin(), ns.end());
+    return { name, iterations, items, ns[ns.size() / 2], ns.front(), ns.back() };
+}
+
+// -----------------------------------------------------------------------------
+// Setup
+// -----------------------------------------------------------------------------
+constexpr uint32_t benchSeed = 1;
+constexpr float    benchDt   = 1.0f / 60.0f;
+
+struct QueryRadius { static constexpr float value = 0.5f; };   // enemy-sized
+
+static Vector3 RandomPoint(std::mt19937& rng, float extent, float y) {
+    std::uniform_real_distribution<float> d(-extent, extent);
+    const float x = d(rng);
+    return { x, y, d(rng) };
+}
+
+static std::vector<AABB> RandomBoxes(int count, float extent) {
+    std::mt19937 rng{ benchSeed };
+    std::uniform_real_distribution<float> size(0.5f, 3.0f);
+    std::vector<AABB> boxes;
+    boxes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const Vector3 p = RandomPoint(rng, extent, 0.0f);
+        boxes.push_back(MakeAABB(p, { size(rng), size(rng), size(rng) }));
+    }
+    return boxes;
+}
+
+// Keeps the scattered crates about as dense as the default level's at any count
+static float BenchFloorSize(int platforms) {
+    return std::max(50.0f, 6.0f * sqrtf((float)platforms));
+}
+
+// The default level plus platforms crates, with the main arena reset onto it
+static void SetUpLevel(int platforms, int enemyLimit) {
+    GameSeedRandom(benchSeed);
+    GameSetEnemyLimit(enemyLimit);
+    GameLoadDefaultLevel();
+    AddBenchmarkPlatforms(platforms, benchSeed, BenchFloorSize(platforms));
+}
+
+// Points over the floor at the height of something standing on it
+static std::vector<Vector3> FloorPoints(int count, float radius) {
+    const AABB& floor = CurrentWorld().platformBounds[0];
+    const float extent = (floor.max.x - floor.min.x) * 0.5f - 1.0f;
+    const float centreX = (floor.min.x + floor.max.x) * 0.5f;
+    const float centreZ = (floor.min.z + floor.max.z) * 0.5f;
+    std::mt19937 rng{ benchSeed + 1 };
+    std::vector<Vector3> points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Vector3 p = RandomPoint(rng, extent, floor.max.y + radius);
+        p.x += centreX;
+        p.z += centreZ;
+        points.push_back(p);
+    }
+    return points;
+}
+
+// -----------------------------------------------------------------------------
+// Cases
+// -----------------------------------------------------------------------------
+// One sphere against every box; the sphere moves each iteration
+static void BenchSphereVsAABB(BenchState& state, int boxCount, int) {
+    const std::vector<AABB> boxes = RandomBoxes(boxCount, 20.0f);
+    std::mt19937 rng{ benchSeed + 1 };
+    Vector3 spheres[64];
+    for (Vector3& s : spheres) s = RandomPoint(rng, 20.0f, 0.0f);
+
+    uint32_t hits = 0;
+    int64_t n = 0;
+    while (state.KeepRunning()) {
+        const Vector3 centre = spheres[n++ & 63];
+        for (const AABB& box : boxes)
+            hits += SphereVsAABB(centre, 0.5f, box);
+    }
+    state.items = boxCount;
+    state.sink = hits;
+}
+
+static void BenchSweptSphereVsAABB(BenchState& state, int boxCount, int) {
+    const std::vector<AABB> boxes = RandomBoxes(boxCount, 20.0f);
+    std::mt19937 rng{ benchSeed + 1 };
+    Vector3 starts[64], ends[64];
+    for (int i = 0; i < 64; ++i) {
+        starts[i] = RandomPoint(rng, 20.0f, 0.0f);
+        ends[i]   = Vector3Add(starts[i], RandomPoint(rng, 2.0f, 0.0f));
+    }
+
+    uint32_t hits = 0;
+    int64_t n = 0;
+    while (state.KeepRunning()) {
+        const int k = (int)(n++ & 63);
+        for (const AABB& box : boxes)
+            hits += SweptSphereVsAABB(starts[k], ends[k], 0.5f, box);
+    }
+    state.items = boxCount;
+    state.sink = hits;
+}
+
+// An enemy's blocked-move test: an enemy-sized sphere against the level's crates
+static void BenchPlatformOverlap(BenchState& state, int queries, int platforms) {
+    SetUpLevel(platforms, 1);
+    const World& world = CurrentWorld();
+    const std::vector<Vector3> points = FloorPoints(queries, QueryRadius::value);
+
+    SpatialQueryStats stats = {};
+    uint32_t hits = 0;
+    while (state.KeepRunning()) {
+        for (const Vector3& p : points)
+            hits += AnyPlatformOverlaps<SkipFloor>(world.platformGrid, world.platformBounds.data(),
+                                                   FixedSphere<QueryRadius>{ p }, stats);
+    }
+    state.items = queries;
+    state.sink = hits + stats.candidatesTested;
+}
+
+// The player's move: gather the platforms a one-tick sweep can reach, then
+// find where it first hits one
+static void BenchPlatformSweep(BenchState& state, int queries, int platforms) {
+    SetUpLevel(platforms, 1);
+    const World& world = CurrentWorld();
+    const float radius = CurrentPlayer().radius;
+    const std::vector<Vector3> points = FloorPoints(queries, radius);
+    std::vector<Vector3> deltas;
+    std::mt19937 rng{ benchSeed + 2 };
+    for (int i = 0; i < queries; ++i) deltas.push_back(RandomPoint(rng, 0.15f, 0.0f));
+
+    std::vector<uint32_t> contacts;
+    contacts.reserve(256);
+    uint64_t hits = 0;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < queries; ++i) {
+            const SweptSphere sweep = { points[i], deltas[i], radius };
+            contacts.clear();
+            QueryPlatforms<AllPlatforms>(world.platformGrid, world.platformBounds.data(), sweep,
+                [&](uint32_t index) {
+                    contacts.push_back(index);
+                    return false;
+                });
+            SweepHit first;
+            hits += FirstPlatformHit<AllPlatforms>(world.platformBounds.data(), contacts.data(),
+                                                   contacts.size(), sweep, first);
+        }
+    }
+    state.items = queries;
+    state.sink = hits;
+}
+
+// The whole player phase, walking in circles among the crates: contact
+// gather, sweep and ground check
+static void BenchPlayerUpdate(BenchState& state, int, int platforms) {
+    SetUpLevel(platforms, 1);
+    Player& player = CurrentPlayer();
+    TickInput input = {};
+    input.moveForward = true;
+    input.mouseDelta  = { 4.0f, 0.0f };
+    GameTick(benchDt, input);
+
+    const Vector3 spawn = player.position;
+    int64_t n = 0;
+    while (state.KeepRunning()) {
+        ArenaReset(frameArena);
+        UpdatePlayer(benchDt, input);
+        // Back to the spawn point now and then, so the walk can't drift off somewhere easy
+        if ((++n & 1023) == 0) {
+            state.Pause();
+            player.position = spawn;
+            state.Resume();
+        }
+    }
+    state.sink = (uint64_t)(player.position.x * 1000.0f);
+}
+
+static void BenchProjectileIntegrate(BenchState& state, int rounds, int) {
+    ProjectilePool pool = {};
+    InitProjectilePool(pool, (size_t)rounds, 0.1f);
+    std::mt19937 rng{ benchSeed };
+    for (int i = 0; i < rounds; ++i)
+        SpawnProjectile(pool, RandomPoint(rng, 20.0f, 1.0f), RandomPoint(rng, 40.0f, 0.0f), 1e9f);
+
+    while (state.KeepRunning())
+        IntegrateProjectiles(pool, benchDt);
+    state.items = rounds;
+    state.sink = (uint64_t)pool.posX[0];
+}
+
+// A quarter of the rounds expire; the pool is refilled between iterations
+static void BenchProjectileCompaction(BenchState& state, int rounds, int) {
+    ProjectilePool pool = {};
+    InitProjectilePool(pool, (size_t)rounds, 0.1f);
+    std::mt19937 rng{ benchSeed };
+    std::vector<float> lifetimes((size_t)rounds);
+    for (float& l : lifetimes) l = (rng() & 3) == 0 ? 0.0f : 1.0f;
+
+    uint64_t live = 0;
+    while (state.KeepRunning()) {
+        state.Pause();
+        ClearProjectiles(pool);
+        for (int i = 0; i < rounds; ++i)
+            SpawnProjectile(pool, { (float)i, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, lifetimes[(size_t)i]);
+        state.Resume();
+        RemoveDeadProjectiles(pool);
+        live += pool.count;
+    }
+    state.items = rounds;
+    state.sink = live;
+}
+
+// Seek, separation and contact for a full pool, restarted from the same spread
+// every iteration so the crowd never settles into a cheaper shape
+static void BenchEnemyUpdate(BenchState& state, int enemies, int platforms) {
+    SetUpLevel(platforms, enemies);
+    World& world = CurrentWorld();
+    Player& player = CurrentPlayer();
+    SpawnEnemies(enemies);
+    GameTick(benchDt, TickInput{});
+
+    const std::vector<Enemy> start(world.enemies.begin(), world.enemies.end());
+    while (state.KeepRunning()) {
+        ArenaReset(frameArena);
+        UpdateEnemies(benchDt);
+        state.Pause();
+        std::copy(start.begin(), start.end(), world.enemies.begin());
+        ConsumeEvents(world.events.playerDamage, [](const PlayerDamagedEvent&) {});
+        player.health = 100;
+        state.Resume();
+    }
+    state.items = (int64_t)start.size();
+    state.sink = world.enemyQueryStats.candidatesTested;
+}
+
+static const BenchCase benchCases[] = {
+    { "SphereVsAABB",        BenchSphereVsAABB,         { 64, 1024, 16384 },   {} },
+    { "SweptSphereVsAABB",   BenchSweptSphereVsAABB,    { 64, 1024, 16384 },   {} },
+    { "PlatformOverlap",     BenchPlatformOverlap,      { 1024 },              { 16, 256, 4096 } },
+    { "PlatformSweep",       BenchPlatformSweep,        { 1024 },              { 16, 256, 4096 } },
+    { "PlayerUpdate",        BenchPlayerUpdate,         {},                    { 16, 256, 4096 } },
+    { "ProjectileIntegrate", BenchProjectileIntegrate,  { 1024, 16384, 65536 }, {} },
+    { "ProjectileCompaction", BenchProjectileCompaction, { 1024, 16384, 65536 }, {} },
+    { "EnemyUpdate",         BenchEnemyUpdate,          { 250, 1000, 4000 },   { 16, 1024 } },
+};
+
+// -----------------------------------------------------------------------------
+// Output
+// -----------------------------------------------------------------------------
+static void WriteJson(FILE* out, const std::vector<BenchResult>& results, const char* executable,
+                      const MicrobenchOptions& opt) {
+    char date[32];
+    const time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+#if defined(NDEBUG)
+    const char* buildType = "release";
+#else
+    const char* buildType = "debug";
+#endif
+#if defined(__AVX2__)
+    const char* simd = "avx2";
+#else
+    const char* simd = "sse2";
+#endif
+
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"date\": \"%s\",\n", date);
+    fprintf(out, "    \"executable\": \"");
+    for (const char* c = executable; *c; ++c) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);   // Windows paths
+        fputc(*c, out);
+    }
+    fprintf(out, "\",\n");
+    fprintf(out, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(out, "    \"library_build_type\": \"%s\",\n", buildType);
+    fprintf(out, "    \"simd\": \"%s\",\n", simd);
+    fprintf(out, "    \"job_threads\": %d,\n", JobsThreadCount());
+    fprintf(out, "    \"repetitions\": %d,\n", opt.repetitions);
+    fprintf(out, "    \"min_time\": %.3f\n  },\n", opt.minTime);
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        // Wall time only; cpu_time repeats it for tools that expect both
+        fprintf(out, "    {\n");
+        fprintf(out, "      \"name\": \"%s\",\n", r.name.c_str());
+        fprintf(out, "      \"run_name\": \"%s\",\n", r.name.c_str());
+        fprintf(out, "      \"run_type\": \"iteration\",\n");
+        fprintf(out, "      \"iterations\": %lld,\n", (long long)r.iterations);
+        fprintf(out, "      \"real_time\": %.3f,\n", r.ns);
+        fprintf(out, "      \"cpu_time\": %.3f,\n", r.ns);
+        fprintf(out, "      \"time_unit\": \"ns\",\n");
+        fprintf(out, "      \"real_time_min\": %.3f,\n", r.nsMin);
+        fprintf(out, "      \"real_time_max\": %.3f,\n", r.nsMax);
+        fprintf(out, "      \"items_per_second\": %.1f\n", (double)r.items * 1e9 / r.ns);
+        fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    MicrobenchOptions opt;
+    if (!ParseOptions(argc, argv, opt)) {
+        PrintUsage();
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    JobsInit(opt.threads);
+    ArenaInit(frameArena);
+
+    // Console table goes to stderr when the JSON takes stdout
+    FILE* table = (opt.json && !strcmp(opt.json, "-")) ? stderr : stdout;
+    if (!opt.list)
+        fprintf(table, "%-34s %14s %14s %12s %14s\n", "benchmark", "ns/iter", "spread", "iterations", "items/s");
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& c : benchCases) {
+        const std::vector<int> entities  = c.entities.empty()  ? std::vector<int>{ 0 } : c.entities;
+        const std::vector<int> platforms = c.platforms.empty() ? std::vector<int>{ 0 } : c.platforms;
+        for (int e : entities) {
+            for (int p : platforms) {
+                std::string name = c.name;
+                if (!c.entities.empty())  name += "/" + std::to_string(e);
+                if (!c.platforms.empty()) name += "/" + std::to_string(p);
+                if (opt.filter && !strstr(name.c_str(), opt.filter)) continue;
+                if (opt.list) {
+                    printf("%s\n", name.c_str());
+                    continue;
+                }
+
+                const BenchResult r = RunCase(c, name, e, p, opt);
+                fprintf(table, "%-34s %14.1f %13.1f%% %12lld %14.4g\n", r.name.c_str(), r.ns,
+                        100.0 * (r.nsMax - r.nsMin) / r.ns, (long long)r.iterations,
+                        (double)r.items * 1e9 / r.ns);
+                fflush(table);
+                results.push_back(r);
+            }
+        }
+    }
+
+    int status = 0;
+    if (opt.json && !opt.list) {
+        FILE* out = strcmp(opt.json, "-") ? fopen(opt.json, "w") : stdout;
+        if (out) {
+            WriteJson(out, results, argv[0], opt);
+            if (out != stdout) fclose(out);
+        } else {
+            fprintf(stderr, "microbench: could not write '%s'\n", opt.json);
+            status = 1;
+        }
+    }
+
+    JobsShutdown();
+    StreamClose();
+    ArenaShutdown(frameArena);
+    return status;
+}
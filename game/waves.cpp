@@ -0,0 +1,55 @@
+#include "waves.h"
+#include <algorithm>
+
+int StepWaveDirector(WaveDirector& director, float dt, int room) {
+    if (director.pending == 0) {
+        director.timer -= dt;
+        if (director.timer > 0.0f) return 0;
+        director.pending = std::min(WaveSize(director.wave), std::max(room, 0));
+        director.wave++;
+        director.timer = waveInterval;
+    }
+    const int count = std::min({ director.pending, waveBurstPerTick, std::max(room, 0) });
+    director.pending -= count;
+    return count;
+}
+
+void PickSpawnPoints(const FlowField& field, Xoshiro128& rng, const XZBounds& area, float margin,
+                     float playerX, float playerZ, float minDistance, int count, Vector2* out) {
+    const float minX = area.minX + margin, maxX = area.maxX - margin;
+    const float minZ = area.minZ + margin, maxZ = area.maxZ - margin;
+    const uint32_t cells = (uint32_t)field.cellsX * (uint32_t)field.cellsZ;
+    const bool hasField = cells > 0 && field.blocked.size() == cells && field.cost.size() == cells;
+    const float minDistSq = minDistance * minDistance;
+    // Within a cell, stay clear of its edges so a neighbour's obstacle can't overlap
+    const float jitter = field.cellSize * 0.25f;
+
+    for (int i = 0; i < count; ++i) {
+        bool found = false, fallback = false;
+        Vector2 point = {}, unreachable = {};
+        for (int t = 0; hasField && t < waveSpawnTries && !found; ++t) {
+            const uint32_t c = XoshiroIndex(rng, cells);
+            const float x = field.originX + ((float)(c % field.cellsX) + 0.5f) * field.cellSize
+                          + XoshiroRange(rng, -jitter, jitter);
+            const float z = field.originZ + ((float)(c / field.cellsX) + 0.5f) * field.cellSize
+                          + XoshiroRange(rng, -jitter, jitter);
+            if (field.blocked[c] || x < minX || x > maxX || z < minZ || z > maxZ) continue;
+            const float dx = x - playerX, dz = z - playerZ;
+            if (dx*dx + dz*dz < minDistSq) continue;
+            if (field.cost[c] != flowUnreachable) {
+                point = { x, z };
+                found = true;
+            } else if (!fallback) {
+                unreachable = { x, z };
+                fallback = true;
+            }
+        }
+        if (!found && fallback) {
+            point = unreachable;
+            found = true;
+        }
+        if (!found)
+            point = { XoshiroRange(rng, minX, maxX), XoshiroRange(rng, minZ, maxZ) };
+        out[i] = point;
+    }
+}